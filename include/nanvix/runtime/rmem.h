@@ -48,19 +48,45 @@
 	#define RMEM_CACHE_LENGTH 32
 	#endif
 
+	/**
+	 * @brief Default associativity of the page cache (fully associative).
+	 */
+	#ifndef __RMEM_CACHE_WAYS
+	#define RMEM_CACHE_WAYS RMEM_CACHE_LENGTH
+	#endif
+
 	/**
 	 * @brief Size of the page cache.
 	 */
 	#define RMEM_CACHE_SIZE (RMEM_CACHE_BLOCK_SIZE*RMEM_CACHE_LENGTH)
 
+	/**
+	 * @brief Number of page frames available to the cache.
+	 *
+	 * The cache may be resized at runtime up to this many pages.
+	 */
+	#ifndef __RMEM_CACHE_FRAMES
+	#define RMEM_CACHE_FRAMES RMEM_CACHE_SIZE
+	#endif
+
+	/**
+	 * @brief Length of the prefetch hint queue (in pages).
+	 */
+	#ifndef __RMEM_CACHE_HINT_LENGTH
+	#define RMEM_CACHE_HINT_LENGTH 16
+	#endif
+
 	/**
 	 * @name Page replacement policies.
 	 */
 	/**@{*/
-	#define RMEM_CACHE_FIFO  0 /**< First In First Out  */
-	#define RMEM_CACHE_LIFO  1 /**< Last In First Out   */
-	#define RMEM_CACHE_LRU   2 /**< Least Recently Used */
-	#define RMEM_CACHE_AGING 3 /**< Aging               */
+	#define RMEM_CACHE_FIFO     0 /**< First In First Out  */
+	#define RMEM_CACHE_LIFO     1 /**< Last In First Out   */
+	#define RMEM_CACHE_LRU      2 /**< Least Recently Used */
+	#define RMEM_CACHE_AGING    3 /**< Aging               */
+	#define RMEM_CACHE_CLOCK    4 /**< Clock               */
+	#define RMEM_CACHE_2Q       5 /**< 2Q (Scan Resistant) */
+	#define RMEM_CACHE_ADAPTIVE 6 /**< Set Dueling         */
 	/**@}*/
 
 	/**
@@ -71,6 +97,51 @@
 	#define RMEM_CACHE_WRITE_THROUGH 1 /**< Write Through */
 	/**@}*/
 
+	/**
+	 * @brief Counters of the stride prefetcher.
+	 *
+	 * Accuracy is @p nuseful over @p nprefetches, and coverage is
+	 * @p nuseful over the sum of @p nuseful and @p nmisses.
+	 */
+	struct nanvix_rcache_prefetch_stats
+	{
+		unsigned nprefetches; /**< Number of lines prefetched.      */
+		unsigned nuseful;     /**< Number of prefetched lines used. */
+		unsigned nmisses;     /**< Number of misses.                */
+	};
+
+	/**
+	 * @brief Sampling period of the page access histogram.
+	 */
+	#ifndef __RMEM_CACHE_HEAT_PERIOD
+	#define RMEM_CACHE_HEAT_PERIOD 16
+	#endif
+
+	/**
+	 * @brief Cache statistics.
+	 *
+	 * Bytes moved are @p nread plus @p nwritten. Entries of @p heat
+	 * are indexed by the server and the block number of a page, and
+	 * count each access with probability 1/RMEM_CACHE_HEAT_PERIOD.
+	 */
+	struct nanvix_rcache_stats
+	{
+		unsigned nhits;          /**< Number of hits.                     */
+		unsigned nmisses;        /**< Number of misses.                   */
+		unsigned nevictions;     /**< Number of lines evicted.            */
+		unsigned nwritebacks;    /**< Number of modified pages evicted.   */
+		unsigned nprefetch_hits; /**< Number of prefetched lines used.    */
+		unsigned nvictim_hits;   /**< Number of victim tier hits.         */
+		unsigned nrejections;    /**< Number of pages refused admission.  */
+		size_t nread;            /**< Bytes read from remote memory.      */
+		size_t nwritten;         /**< Bytes written to remote memory.     */
+
+		/**
+		 * @brief Sampled accesses to each page.
+		 */
+		unsigned heat[RMEM_SERVERS_NUM][RMEM_NUM_BLOCKS];
+	};
+
 	/**
 	 * @brief Allocates a remote page.
 	 *
@@ -80,6 +151,18 @@
 	 */
 	extern rpage_t nanvix_rcache_alloc(void);
 
+	/**
+	 * @brief Allocates many remote pages.
+	 *
+	 * @param pgnums Store location for the numbers of the pages.
+	 * @param n      Number of pages.
+	 *
+	 * @returns Upon successful completion, zero is returned. Upon
+	 * failure, no page is allocated and a negative error code is
+	 * returned instead.
+	 */
+	extern int nanvix_rcache_alloc_n(rpage_t *pgnums, int n);
+
 	/**
 	 * @brief Cleans the cache..
 	 */
@@ -98,6 +181,9 @@
 	/**
 	 * @brief Gets remote page.
 	 *
+	 * The page stays in the cache until it is put back. If all lines
+	 * in which it may be loaded are in use, the caller waits.
+	 *
 	 * @param pgnum Number of the target page.
 	 *
 	 * @returns Upon successful completion, a pointer to a local
@@ -106,6 +192,47 @@
 	 */
 	extern void *nanvix_rcache_get(rpage_t pgnum);
 
+	/**
+	 * @brief Gets remote page that is about to be overwritten.
+	 *
+	 * On a miss the page is not read from remote memory, thus the
+	 * caller should overwrite it as a whole. The page is marked as
+	 * modified.
+	 *
+	 * @param pgnum Number of the target page.
+	 *
+	 * @returns Upon successful completion, a pointer to a local
+	 * mapping of the remote page is returned. Upon failure, a @p
+	 * NULL pointer is returned instead.
+	 */
+	extern void *nanvix_rcache_overwrite(rpage_t pgnum);
+
+	/**
+	 * @brief Reads a remote page without caching it.
+	 *
+	 * @param pgnum  Number of the target page.
+	 * @param buf    Local buffer where data should be placed.
+	 * @param offset Offset within the page (in bytes).
+	 * @param n      Number of bytes to read.
+	 *
+	 * @returns Upon successful completion, zero is returned. Upon
+	 * failure, a negative error code is returned instead.
+	 */
+	extern int nanvix_rcache_bypass_read(rpage_t pgnum, void *buf, size_t offset, size_t n);
+
+	/**
+	 * @brief Writes a remote page without caching it.
+	 *
+	 * @param pgnum  Number of the target page.
+	 * @param buf    Local buffer from where data should be retrieved.
+	 * @param offset Offset within the page (in bytes).
+	 * @param n      Number of bytes to write.
+	 *
+	 * @returns Upon successful completion, zero is returned. Upon
+	 * failure, a negative error code is returned instead.
+	 */
+	extern int nanvix_rcache_bypass_write(rpage_t pgnum, const void *buf, size_t offset, size_t n);
+
 	/**
 	 * @brief Puts remote page.
 	 *
@@ -126,13 +253,164 @@
 	 */
 	extern int nanvix_rcache_flush(rpage_t pgnum);
 
+	/**
+	 * @brief Marks a remote page as modified.
+	 *
+	 * @param pgnum Number of the target page.
+	 *
+	 * @returns Upon successful completion, zero is returned. Upon
+	 * failure a negative error code is returned instead.
+	 */
+	extern int nanvix_rcache_dirty(rpage_t pgnum);
+
 	/**
 	 * @brief Selects the cache replacement_policy.
 	 *
+	 * Under RMEM_CACHE_ADAPTIVE, a few leader sets run each of FIFO,
+	 * LIFO, LRU and CLOCK, and the other sets follow the one that
+	 * currently misses less. Leader sets are taken only if the cache
+	 * has at least eight sets, otherwise all sets run LRU.
+	 *
 	 * @param num Number of the replacement policy.
 	 */
 	extern int nanvix_rcache_select_replacement_policy(int num);
 
+	/**
+	 * @brief Selects the associativity of the cache.
+	 *
+	 * @param ways Number of lines in a set. It should evenly divide
+	 * RMEM_CACHE_LENGTH.
+	 *
+	 * @returns Upon successful completion, zero is returned. Upon
+	 * failure a negative error code is returned instead.
+	 */
+	extern int nanvix_rcache_select_associativity(int ways);
+
+	/**
+	 * @brief Sets the geometry of the cache.
+	 *
+	 * @param nlines     Number of lines.
+	 * @param block_size Number of pages in a line.
+	 *
+	 * @returns Upon successful completion, zero is returned. Upon
+	 * failure a negative error code is returned instead.
+	 */
+	extern int nanvix_rcache_init(int nlines, int block_size);
+
+	/**
+	 * @brief Changes the number of lines in the cache.
+	 *
+	 * @param nlines Number of lines.
+	 *
+	 * @returns Upon successful completion, zero is returned. Upon
+	 * failure a negative error code is returned instead.
+	 */
+	extern int nanvix_rcache_resize(int nlines);
+
+	/**
+	 * @brief Waits for pending prefetches and write-backs to complete.
+	 *
+	 * @returns Upon successful completion, zero is returned. If a
+	 * write-back failed since the last call, a negative error code is
+	 * returned instead.
+	 */
+	extern int nanvix_rcache_sync(void);
+
+	/**
+	 * @brief Hints pages that are about to be accessed.
+	 *
+	 * @param pgnum Number of the first page.
+	 * @param n     Number of pages.
+	 *
+	 * @returns Upon successful completion, zero is returned. Upon
+	 * failure a negative error code is returned instead.
+	 */
+	extern int nanvix_rcache_prefetch(rpage_t pgnum, int n);
+
+	/**
+	 * @brief Hints pages that are no longer needed.
+	 *
+	 * @param pgnum Number of the first page.
+	 * @param n     Number of pages.
+	 *
+	 * @returns Upon successful completion, zero is returned. Upon
+	 * failure a negative error code is returned instead.
+	 */
+	extern int nanvix_rcache_release(rpage_t pgnum, int n);
+
+	/**
+	 * @brief Turns the stride prefetcher on or off.
+	 *
+	 * @param enable Non-zero to turn the prefetcher on.
+	 *
+	 * @returns Zero is returned.
+	 */
+	extern int nanvix_rcache_select_prefetch(int enable);
+
+	/**
+	 * @brief Turns the compressed victim tier on or off.
+	 *
+	 * @param enable Non-zero to turn the victim tier on.
+	 *
+	 * @returns Zero is returned.
+	 */
+	extern int nanvix_rcache_select_victim(int enable);
+
+	/**
+	 * @brief Turns the admission filter on or off.
+	 *
+	 * When the filter is on, a missing page that was accessed less
+	 * often than the page it would evict replaces only pages that
+	 * were refused before, if there are any.
+	 *
+	 * @param enable Non-zero to turn the filter on.
+	 *
+	 * @returns Zero is returned.
+	 */
+	extern int nanvix_rcache_select_filter(int enable);
+
+	/**
+	 * @brief Reports the counters of the stride prefetcher.
+	 *
+	 * @param buf Target buffer.
+	 *
+	 * @returns Upon successful completion, zero is returned. Upon
+	 * failure a negative error code is returned instead.
+	 */
+	extern int nanvix_rcache_prefetch_stats(struct nanvix_rcache_prefetch_stats *buf);
+
+	/**
+	 * @brief Reports the statistics of the cache.
+	 *
+	 * @param buf Target buffer.
+	 *
+	 * @returns Upon successful completion, zero is returned. Upon
+	 * failure a negative error code is returned instead.
+	 */
+	extern int nanvix_rcache_stats(struct nanvix_rcache_stats *buf);
+
+	/**
+	 * @brief Estimates the miss ratio of the cache for some size.
+	 *
+	 * @param npages Size of the cache (in pages).
+	 *
+	 * @returns Upon successful completion, the estimated miss ratio
+	 * (in thousandths) is returned. Upon failure a negative error
+	 * code is returned instead.
+	 */
+	extern int nanvix_rcache_miss_ratio(int npages);
+
+	/**
+	 * @brief Resizes the cache to meet a target miss ratio.
+	 *
+	 * @param target Target miss ratio (in thousandths).
+	 *
+	 * @returns Upon successful completion, the new number of lines
+	 * is returned. Upon failure a negative error code is returned
+	 * instead.
+	 */
+	extern int nanvix_rcache_autosize(int target);
+
 	/**
 	 * @brief Selects the write policy.
 	 *
@@ -153,6 +431,20 @@
 	 */
 	extern void *nanvix_vmem_alloc(size_t n);
 
+	/**
+	 * @brief Reserves remote memory.
+	 *
+	 * Pages of the reserved area are allocated in remote memory on
+	 * first touch. Pages that were never touched read as zeros.
+	 *
+	 * @param n Number of pages to reserve.
+	 *
+	 * @returns Upon successful completion, a pointer to the newly
+	 * reserved remote memory area is returned. Upon failure, a null
+	 * pointer is returned instead.
+	 */
+	extern void *nanvix_vmem_reserve(size_t n);
+
 	/**
 	 * @brief Frees remote memory.
 	 *
@@ -170,7 +462,9 @@
 	 * @param ptr Target remote memory area.
 	 * @param n   Number of bytes to read.
 	 *
-	 * @returns The number of bytes read from remote memory.
+	 * @returns The number of bytes read from remote memory. The range may
+	 * span many pages, and fewer than @p n bytes are read if a page
+	 * could not be accessed.
 	 */
 	extern size_t nanvix_vmem_read(void *buf, const void *ptr, size_t n);
 
@@ -181,10 +475,40 @@
 	 * @param buf Local buffer from where data should be retrieved.
 	 * @param n   Number of bytes to write.
 	 *
-	 * @returns The number of bytes written to remote memory.
+	 * @returns The number of bytes written to remote memory. The range may
+	 * span many pages, and fewer than @p n bytes are written if a page
+	 * could not be accessed.
 	 */
 	extern size_t nanvix_vmem_write(void *ptr, const void *buf, size_t n);
 
+	/**
+	 * @brief Reads data from remote memory without caching it.
+	 *
+	 * Meant for one-pass scans, which would otherwise evict the
+	 * working set from the cache.
+	 *
+	 * @param buf Local buffer where data should be placed.
+	 * @param ptr Target remote memory area.
+	 * @param n   Number of bytes to read.
+	 *
+	 * @returns The number of bytes read from remote memory.
+	 */
+	extern size_t nanvix_vmem_stream_read(void *buf, const void *ptr, size_t n);
+
+	/**
+	 * @brief Writes data to remote memory without caching it.
+	 *
+	 * Meant for one-pass scans, which would otherwise evict the
+	 * working set from the cache.
+	 *
+	 * @param ptr Target remote memory area.
+	 * @param buf Local buffer from where data should be retrieved.
+	 * @param n   Number of bytes to write.
+	 *
+	 * @returns The number of bytes written to remote memory.
+	 */
+	extern size_t nanvix_vmem_stream_write(void *ptr, const void *buf, size_t n);
+
 	/**
 	 * @brief Handles a remote page fault.
 	 *
@@ -123,4 +123,39 @@
 	 */
 	extern int __nanvix_rmem_cleanup(void);
 
+	/**
+	 * @brief Initializes the prefetch and write-behind queues of the
+	 * page cache.
+	 *
+	 * @returns Upon successful completion, zero is returned. Upon
+	 * failure, a negative error code is returned instead.
+	 */
+	extern int __nanvix_rcache_setup(void);
+
+	/**
+	 * @brief Asks the prefetcher and write-behind threads to stop.
+	 *
+	 * The write-behind thread drains its queue before it stops.
+	 *
+	 * @returns Upon successful completion, zero is returned. Upon
+	 * failure, a negative error code is returned instead.
+	 */
+	extern int __nanvix_rcache_cleanup(void);
+
+	/**
+	 * @brief Writes back pages evicted from the page cache.
+	 *
+	 * This is the body of the write-behind thread. It returns once
+	 * __nanvix_rcache_cleanup() is called and the queue is drained.
+	 */
+	extern void nanvix_rcache_write_behind(void);
+
+	/**
+	 * @brief Loads pages hinted to the page cache.
+	 *
+	 * This is the body of the prefetcher thread. It returns once
+	 * __nanvix_rcache_cleanup() is called.
+	 */
+	extern void nanvix_rcache_prefetcher(void);
+
 #endif /* NANVIX_RUNTIME_RUNTIME_H_ */
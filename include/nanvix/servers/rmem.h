@@ -61,6 +61,11 @@
 	 */
 	#define RMEM_NUM_BLOCKS (RMEM_SIZE/RMEM_BLOCK_SIZE)
 
+	/**
+	 * @brief Maximum number of blocks in a bulk allocation.
+	 */
+	#define RMEM_ALLOC_N_MAX 64
+
 	/**
 	 * @name Shifts for remote addresses.
 	 */
@@ -134,6 +139,7 @@
 	#define RMEM_ALLOC   3 /**< Alloc       */
 	#define RMEM_MEMFREE 4 /**< Free        */
 	#define RMEM_ACK     5 /**< Acknowledge */
+	#define RMEM_ALLOC_N 6 /**< Bulk Alloc  */
 	/**@}*/
 
 	/**
@@ -141,9 +147,10 @@
 	 */
 	struct rmem_message
 	{
-		message_header header; /**< Message header. */
-		rpage_t blknum;        /**< Block number.   */
-		int errcode;           /**< Error code.     */
+		message_header header; /**< Message header.   */
+		rpage_t blknum;        /**< Block number.     */
+		int nblocks;           /**< Number of blocks. */
+		int errcode;           /**< Error code.       */
 	};
 
 	/**
@@ -168,6 +175,21 @@
 	 */
 	extern rpage_t nanvix_rmem_alloc(void);
 
+	/**
+	 * @brief Allocates many remote memory blocks.
+	 *
+	 * Blocks are allocated in batches of at most @p RMEM_ALLOC_N_MAX,
+	 * each one with a single request to a server.
+	 *
+	 * @param blknums Store location for the numbers of the blocks.
+	 * @param n       Number of blocks.
+	 *
+	 * @returns Upon successful completion, zero is returned. Upon
+	 * failure, no block is allocated and a negative error code is
+	 * returned instead.
+	 */
+	extern int nanvix_rmem_alloc_n(rpage_t *blknums, int n);
+
 	/**
 	 * @brief Frees a remote memory block.
 	 *
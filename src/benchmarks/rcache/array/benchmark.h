@@ -30,7 +30,7 @@
 	 */
 	struct workload
 	{
-		char type;     /**< Access type. */
+		char type;     /**< Access type ('L'oad or 'S'tore). */
 		unsigned page; /**< Page number. */
 	};
 
@@ -27,6 +27,7 @@
 #include <nanvix/runtime/rmem.h>
 #include <nanvix/runtime/runtime.h>
 #include <nanvix/runtime/stdikc.h>
+#include <nanvix/sys/perf.h>
 #include <nanvix/ulib.h>
 #include <nanvix/ulib.h>
 #include "benchmark.h"
@@ -38,6 +39,22 @@
 #define NUM_PAGES (RMEM_SERVERS_NUM*(RMEM_NUM_BLOCKS - 1))
 #endif
 
+/**
+ * @brief Replacement policies to benchmark.
+ */
+static const struct
+{
+	int num;          /**< Number of the policy. */
+	const char *name; /**< Name of the policy.   */
+} policies[] = {
+	{ RMEM_CACHE_FIFO,  "fifo"  },
+	{ RMEM_CACHE_LIFO,  "lifo"  },
+	{ RMEM_CACHE_LRU,   "lru"   },
+	{ RMEM_CACHE_CLOCK, "clock" },
+	{ RMEM_CACHE_2Q,    "2q"    },
+	{ -1,               NULL    },
+};
+
 #ifndef __WORKLOAD_CUSTOM
 
 /**
@@ -68,13 +85,48 @@ static void workload_build(void)
 {
 	for (int i = 0; i < __WORKLOAD_SIZE; ++i)
 	{
-		work[i].type = i%2;
+		work[i].type = (i%2) ? 'S' : 'L';
 		work[i].page = i%RMEM_CACHE_LENGTH;
 	}
 }
 
 #endif /* !WORKLOAD_CUSTOM */
 
+/**
+ * @brief Replays the workload on a cold cache.
+ *
+ * @param raw_pages Remote pages.
+ * @param policy    Replacement policy.
+ * @param skipped   Store location for the number of skipped lines.
+ *
+ * @returns The number of cycles spent.
+ */
+static uint64_t benchmark_run(const rpage_t *raw_pages, int policy, int *skipped)
+{
+	/* Start from a cold cache. */
+	nanvix_rcache_clean();
+	uassert(nanvix_rcache_select_replacement_policy(policy) == 0);
+
+	*skipped = 0;
+	perf_start(0, PERF_CYCLES);
+	for (int i = 0; i < workload_size; i++)
+	{
+		if (work[i].page >= NUM_PAGES)
+		{
+			(*skipped)++;
+			continue;
+		}
+
+		uassert(nanvix_rcache_get(raw_pages[work[i].page]) != NULL);
+		if (work[i].type == 'S')
+			uassert(nanvix_rcache_dirty(raw_pages[work[i].page]) == 0);
+		uassert(nanvix_rcache_put(raw_pages[work[i].page], 1) == 0);
+	}
+	perf_stop(0);
+
+	return (perf_read(0));
+}
+
 /**
  * @brief Syntetic Benchmark
  */
@@ -83,7 +135,8 @@ int __main2(int argc, const char *argv[])
 	((void) argc);
 	((void) argv);
 
-	int skipped = 0;
+	int skipped;
+	uint64_t time_rw;
 	static rpage_t raw_pages[NUM_PAGES];
 
 #ifndef __WORKLOAD_CUSTOM
@@ -104,19 +157,49 @@ int __main2(int argc, const char *argv[])
 		for (int i = 0; i < NUM_PAGES; i++)
 			uassert((raw_pages[i] = nanvix_rcache_alloc()) != 0);
 
-		uprintf("[nanvix][benchmark] applying puts and gets");
-		for (int i = 0; i < workload_size; i++)
+		/* Sweep from direct-mapped to fully associative. */
+		for (int ways = 1; ways <= RMEM_CACHE_LENGTH; ways *= 2)
 		{
-			if (work[i].page >= NUM_PAGES)
-			{
-				skipped++;
+			if ((RMEM_CACHE_LENGTH % ways) != 0)
 				continue;
+
+			uassert(nanvix_rcache_select_associativity(ways) == 0);
+
+			for (int p = 0; policies[p].name != NULL; p++)
+			{
+				uprintf("[nanvix][benchmark] applying puts and gets (%s, %d-way)", policies[p].name, ways);
+
+				time_rw = benchmark_run(raw_pages, policies[p].num, &skipped);
+
+				uprintf("[nanvix][benchmark] %d lines skipped", skipped);
+				uprintf("[nanvix][benchmark] %s %d-way rw %l", policies[p].name, ways, time_rw);
 			}
+		}
 
-			uassert(nanvix_rcache_get(raw_pages[work[i].page]) != NULL);
-			uassert(nanvix_rcache_put(raw_pages[work[i].page], 1) == 0);
+		/* Stride prefetcher. */
+		uassert(nanvix_rcache_select_associativity(RMEM_CACHE_WAYS) == 0);
+		uassert(nanvix_rcache_select_prefetch(1) == 0);
+		for (int p = 0; policies[p].name != NULL; p++)
+		{
+			struct nanvix_rcache_prefetch_stats before;
+			struct nanvix_rcache_prefetch_stats after;
+
+			uprintf("[nanvix][benchmark] applying puts and gets (%s, prefetch)", policies[p].name);
+
+			uassert(nanvix_rcache_prefetch_stats(&before) == 0);
+			time_rw = benchmark_run(raw_pages, policies[p].num, &skipped);
+			uassert(nanvix_rcache_prefetch_stats(&after) == 0);
+
+			uprintf("[nanvix][benchmark] %d lines skipped", skipped);
+			uprintf("[nanvix][benchmark] %s prefetch rw %l", policies[p].name, time_rw);
+			uprintf("[nanvix][benchmark] %s prefetch issued %d useful %d misses %d",
+				policies[p].name,
+				after.nprefetches - before.nprefetches,
+				after.nuseful - before.nuseful,
+				after.nmisses - before.nmisses
+			);
 		}
-		uprintf("[nanvix][benchmark] %d lines skipped", skipped);
+		uassert(nanvix_rcache_select_prefetch(0) == 0);
 
 		uprintf("[nanvix][benchmark] freeing pages: %d", NUM_PAGES);
 		for (int i = 0; i < NUM_PAGES; i++)
@@ -95,6 +95,7 @@ int __main2(int argc, const char *argv[])
 	((void) argv);
 
 	int skipped = 0;
+	char *area;
 	void *pages[NUM_PAGES];
 	uint64_t time_alloc, time_rw, time_free;
 
@@ -112,13 +113,14 @@ int __main2(int argc, const char *argv[])
 
 		__runtime_setup(3);
 
-		/* Allocate many blocks.*/
+		/* Allocate many blocks at once. */
 		uprintf("[nanvix][benchmark] allocating pages: %d", NUM_PAGES);
 		perf_start(0, PERF_CYCLES);
-		for (int i = 0; i < NUM_PAGES; i++)
-			uassert((pages[i] = nanvix_vmem_alloc(1)) != NULL);
+		uassert((area = nanvix_vmem_alloc(NUM_PAGES)) != NULL);
 		perf_stop(0);
 		time_alloc = perf_read(0);
+		for (int i = 0; i < NUM_PAGES; i++)
+			pages[i] = &area[i*RMEM_BLOCK_SIZE];
 
 		/* Read and write. */
 		uprintf("[nanvix][benchmark] read and writing");
@@ -146,8 +148,7 @@ int __main2(int argc, const char *argv[])
 		/* Free all blocks. */
 		uprintf("[nanvix][benchmark] freeing pages: %d", NUM_PAGES);
 		perf_start(0, PERF_CYCLES);
-		for (int i = NUM_PAGES - 1; i >= 0; i--)
-			uassert(nanvix_vmem_free(pages[i]) == 0);
+		uassert(nanvix_vmem_free(area) == 0);
 		perf_stop(0);
 		time_free = perf_read(0);
 
@@ -79,6 +79,71 @@ static void *nanvix_exception_handler(void *args)
 	return (NULL);
 }
 
+/**
+ * @brief ID of the thread that started the page cache threads.
+ *
+ * The page cache is shared by all threads of the cluster, thus its
+ * threads are spawned by the first thread that reaches ring 3, and
+ * they are joined when that thread shuts the ring down.
+ */
+static int rcache_owner = -1;
+
+/**
+ * @brief ID of write-behind thread.
+ */
+static kthread_t write_behind_tid;
+
+/**
+ * @brief Write-behind thread of the page cache.
+ *
+ * @param args Arguments for the thread (unused).
+ *
+ * @returns Always return NULL.
+ */
+static void *nanvix_write_behind_handler(void *args)
+{
+	UNUSED(args);
+
+	uassert(__stdsync_setup() == 0);
+	uassert(__stdmailbox_setup() == 0);
+	uassert(__stdportal_setup() == 0);
+	uassert(__name_setup() == 0);
+	uassert(__nanvix_mailbox_setup() == 0);
+	uassert(__nanvix_portal_setup() == 0);
+
+	nanvix_rcache_write_behind();
+
+	return (NULL);
+}
+
+/**
+ * @brief ID of prefetcher thread.
+ */
+static kthread_t prefetcher_tid;
+
+/**
+ * @brief Prefetcher thread of the page cache.
+ *
+ * @param args Arguments for the thread (unused).
+ *
+ * @returns Always return NULL.
+ */
+static void *nanvix_prefetcher_handler(void *args)
+{
+	UNUSED(args);
+
+	uassert(__stdsync_setup() == 0);
+	uassert(__stdmailbox_setup() == 0);
+	uassert(__stdportal_setup() == 0);
+	uassert(__name_setup() == 0);
+	uassert(__nanvix_mailbox_setup() == 0);
+	uassert(__nanvix_portal_setup() == 0);
+
+	nanvix_rcache_prefetcher();
+
+	return (NULL);
+}
+
 /**
  * @brief Forces a platform-independent delay.
  *
@@ -150,6 +215,15 @@ int __runtime_setup(int ring)
 		delay(CLUSTER_FREQ);
 		uassert(__nanvix_rmem_setup() == 0);
 		uassert(kthread_create(&exception_handler_tid, &nanvix_exception_handler, NULL) == 0);
+
+		/* Start page cache threads. */
+		if (rcache_owner < 0)
+		{
+			uassert(__nanvix_rcache_setup() == 0);
+			uassert(kthread_create(&write_behind_tid, &nanvix_write_behind_handler, NULL) == 0);
+			uassert(kthread_create(&prefetcher_tid, &nanvix_prefetcher_handler, NULL) == 0);
+			rcache_owner = tid;
+		}
 	}
 
 	current_ring[tid] = ring;
@@ -170,6 +244,16 @@ int __runtime_cleanup(void)
 	if (current_ring[tid] >= 3)
 	{
 		uprintf("[nanvix][thread %d] shutting down ring 3", tid);
+
+		/* Stop page cache threads. */
+		if (rcache_owner == tid)
+		{
+			uassert(__nanvix_rcache_cleanup() == 0);
+			uassert(kthread_join(prefetcher_tid, NULL) == 0);
+			uassert(kthread_join(write_behind_tid, NULL) == 0);
+			rcache_owner = -1;
+		}
+
 		uassert(__nanvix_rmem_cleanup() == 0);
 		uassert(kthread_join(exception_handler_tid, NULL) == 0);
 	}
@@ -26,6 +26,10 @@
 #define __NEED_RMEM_CACHE
 
 #include <nanvix/runtime/rmem.h>
+#include <nanvix/runtime/utils.h>
+#include <nanvix/sys/mutex.h>
+#include <nanvix/sys/semaphore.h>
+#include <nanvix/sys/thread.h>
 #include <nanvix/ulib.h>
 #include <posix/errno.h>
 
@@ -34,513 +38,4620 @@
  */
 static struct
 {
-	unsigned nmisses; /**< Number of misses.     */
-	unsigned nhits;   /**< Number of hits.       */
-	unsigned nallocs; /**< Number of allocations */
-} stats = { 0, 0, 0 };
+	unsigned nmisses;        /**< Number of misses.                 */
+	unsigned nhits;          /**< Number of hits.                   */
+	unsigned nallocs;        /**< Number of allocations             */
+	unsigned nprefetches;    /**< Number of lines prefetched.       */
+	unsigned nprefetch_hits; /**< Number of prefetched lines used.  */
+	unsigned nevictions;     /**< Number of lines evicted.          */
+	unsigned nwritebacks;    /**< Number of modified pages evicted. */
+	unsigned nvictim_hits;   /**< Number of victim tier hits.       */
+	unsigned nrejections;    /**< Number of pages refused.          */
+	size_t nread;            /**< Number of bytes read.             */
+	size_t nwritten;         /**< Number of bytes written.          */
+	uint32_t seed;           /**< State of the access sampler.      */
+
+	/**
+	 * @brief Sampled accesses to each page.
+	 */
+	unsigned heat[RMEM_SERVERS_NUM][RMEM_NUM_BLOCKS];
+} stats = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2463534242U, { { 0 } } };
+
+/**
+ * @brief Sampling period of the miss ratio curve (in pages).
+ */
+#ifndef __RMEM_CACHE_MRC_PERIOD
+#define RMEM_CACHE_MRC_PERIOD 4
+#endif
+
+/**
+ * @brief Depth of the reuse stack of sampled pages.
+ *
+ * Sampled pages that are deeper than this are farther apart than the
+ * largest cache could hold.
+ */
+#define RMEM_CACHE_MRC_DEPTH (RMEM_CACHE_FRAMES/RMEM_CACHE_MRC_PERIOD + 1)
+
+/**
+ * @brief Asserts whether or not accesses to a page are sampled.
+ *
+ * Pages are picked by a hash of their number, so that the sample does
+ * not depend on the layout of data, and that all accesses to a page
+ * are either sampled or not.
+ */
+#define RMEM_CACHE_MRC_SAMPLED(pgnum) \
+	(((((uint32_t)(pgnum))*2654435761U) >> 16) % RMEM_CACHE_MRC_PERIOD == 0)
+
+/**
+ * @brief Miss ratio curve.
+ *
+ * Reuse distances of a sample of the pages (SHARDS) are measured on an
+ * LRU stack of the sampled pages only, and scaled by the sampling
+ * period. An access hits an LRU cache of some size if its distance is
+ * smaller than that size, so the histogram of distances gives the miss
+ * ratio of every cache size at once. It is guarded by the statistics
+ * lock.
+ */
+static struct
+{
+	rpage_t stack[RMEM_CACHE_MRC_DEPTH]; /**< Sampled pages, most recent first. */
+	int length;                          /**< Number of pages in the stack.     */
+	unsigned hist[RMEM_CACHE_MRC_DEPTH]; /**< Reuses at each distance.          */
+	unsigned naccesses;                  /**< Number of sampled accesses.       */
+} cache_mrc = { { RMEM_NULL }, 0, { 0 }, 0 };
+
+/**
+ * @brief Number of counters in a row of the frequency sketch.
+ */
+#ifndef __RMEM_CACHE_FILTER_WIDTH
+#define RMEM_CACHE_FILTER_WIDTH (8*RMEM_CACHE_FRAMES)
+#endif
+
+/**
+ * @brief Number of rows of the frequency sketch.
+ */
+#define RMEM_CACHE_FILTER_DEPTH 4
+
+/**
+ * @brief Largest count of the frequency sketch.
+ */
+#define RMEM_CACHE_FILTER_MAX 15
+
+/**
+ * @brief Number of accesses after which counts are halved.
+ */
+#define RMEM_CACHE_FILTER_SAMPLE (10*RMEM_CACHE_FRAMES)
+
+/**
+ * @brief Admission filter.
+ *
+ * Accesses are counted in a count-min sketch (TinyLFU), whose counts
+ * are halved every RMEM_CACHE_FILTER_SAMPLE accesses, so that old
+ * accesses fade out. A missing page is admitted only if it was seen
+ * more often than the page it would evict. It is guarded by the
+ * statistics lock.
+ */
+static struct
+{
+	uint8_t counts[RMEM_CACHE_FILTER_DEPTH][RMEM_CACHE_FILTER_WIDTH]; /**< Counters.             */
+	unsigned naccesses;                                              /**< Accesses since aging. */
+	int enabled;                                                     /**< Is the filter on?     */
+} cache_filter = {
+	.counts = { { 0 } },
+	.naccesses = 0,
+#ifdef __RMEM_CACHE_FILTER
+	.enabled = 1,
+#else
+	.enabled = 0,
+#endif
+};
+
+/**
+ * @brief Seeds of the hash functions of the frequency sketch.
+ */
+static const uint32_t cache_filter_seeds[RMEM_CACHE_FILTER_DEPTH] = {
+	0x9e3779b1U, 0x85ebca77U, 0xc2b2ae3dU, 0x27d4eb2fU
+};
+
+/**
+ * @brief Number of policies that compete under set dueling.
+ */
+#define RMEM_CACHE_DUEL_NCANDIDATES 4
+
+/**
+ * @brief Distance between leader sets of the same policy.
+ *
+ * The first RMEM_CACHE_DUEL_NCANDIDATES sets of every period are led
+ * by one policy each, and the remaining ones follow the winner.
+ */
+#ifndef __RMEM_CACHE_DUEL_PERIOD
+#define RMEM_CACHE_DUEL_PERIOD (2*RMEM_CACHE_DUEL_NCANDIDATES)
+#endif
+
+/**
+ * @brief Number of accesses to leader sets after which counts are halved.
+ */
+#ifndef __RMEM_CACHE_DUEL_EPOCH
+#define RMEM_CACHE_DUEL_EPOCH 256
+#endif
+
+/**
+ * @brief Set dueling.
+ *
+ * Accesses and misses in the leader sets of each candidate policy are
+ * counted, and the policy with the lowest miss ratio leads follower
+ * sets. Counts are halved every RMEM_CACHE_DUEL_EPOCH accesses, so that
+ * the winner tracks phases of the workload. It is guarded by the
+ * statistics lock.
+ */
+static struct
+{
+	unsigned naccesses[RMEM_CACHE_DUEL_NCANDIDATES]; /**< Accesses to leader sets. */
+	unsigned nmisses[RMEM_CACHE_DUEL_NCANDIDATES];   /**< Misses in leader sets.   */
+	unsigned nepoch;                                 /**< Accesses in this epoch.  */
+	int winner;                                      /**< Current winner.          */
+} cache_duel = { { 0 }, { 0 }, 0, 0 };
+
+/**
+ * @brief Policies that compete under set dueling.
+ *
+ * Their state is kept up to date regardless of the policy in use.
+ */
+static const int cache_duel_candidates[RMEM_CACHE_DUEL_NCANDIDATES] = {
+	RMEM_CACHE_LRU, RMEM_CACHE_FIFO, RMEM_CACHE_CLOCK, RMEM_CACHE_LIFO
+};
+
+/**
+ * @brief Length of the page lookup table (must be a power of two).
+ */
+#ifndef __RMEM_CACHE_HASH_LENGTH
+#define RMEM_CACHE_HASH_LENGTH 1024
+#endif
+
+/**
+ * @brief Hashes a remote page number.
+ *
+ * Pages of a server are numbered sequentially, so folding the server
+ * number onto the block number spreads pages evenly over the table.
+ */
+#define RMEM_CACHE_HASH(pgnum) \
+	(((pgnum) ^ ((pgnum) >> RMEM_BLOCK_SERVER_SHIFT)) & (RMEM_CACHE_HASH_LENGTH - 1))
+
+/**
+ * @brief Null slot index.
+ */
+#define RMEM_CACHE_NULL (-1)
+
+/**
+ * @brief No line to keep, and the incoming page skips the admission filter.
+ */
+#define RMEM_CACHE_NONE (-2)
+
+/**
+ * @name Cache slot flags.
+ */
+/**@{*/
+#define RMEM_CACHE_SLOT_REF       (1 << 0) /**< Referenced          */
+#define RMEM_CACHE_SLOT_A1IN      (1 << 1) /**< In 2Q's A1in queue. */
+#define RMEM_CACHE_SLOT_DIRTY     (1 << 2) /**< Modified            */
+#define RMEM_CACHE_SLOT_PREFETCH  (1 << 3) /**< Prefetched, unused. */
+#define RMEM_CACHE_SLOT_BUSY      (1 << 4) /**< Being loaded.       */
+#define RMEM_CACHE_SLOT_RELEASED  (1 << 5) /**< First to evict.     */
+#define RMEM_CACHE_SLOT_PROBATION (1 << 6) /**< Refused admission.  */
+/**@}*/
+
+/**
+ * @brief Maximum length of 2Q's A1in queue in a set (in lines).
+ */
+#define RMEM_CACHE_2Q_KIN \
+	((cache_ways/4 > 0) ? (cache_ways/4) : 1)
+
+/**
+ * @brief Length of 2Q's A1out ghost queue (in pages).
+ */
+#define RMEM_CACHE_2Q_KOUT \
+	((cache_length/2 > 0) ? (cache_length/2) : 1)
+
+/**
+ * @brief Largest length of 2Q's A1out ghost queue (in pages).
+ */
+#define RMEM_CACHE_2Q_KOUT_MAX \
+	((RMEM_CACHE_FRAMES/2 > 0) ? (RMEM_CACHE_FRAMES/2) : 1)
+
+/**
+ * @brief Number of access streams tracked by the prefetcher.
+ */
+#ifndef __RMEM_CACHE_PREFETCH_STREAMS
+#define RMEM_CACHE_PREFETCH_STREAMS 4
+#endif
+
+/**
+ * @brief Number of lines prefetched ahead of a stream.
+ */
+#ifndef __RMEM_CACHE_PREFETCH_DEGREE
+#define RMEM_CACHE_PREFETCH_DEGREE 2
+#endif
+
+/**
+ * @brief Largest stride followed by the prefetcher (in pages).
+ */
+#ifndef __RMEM_CACHE_PREFETCH_WINDOW
+#define RMEM_CACHE_PREFETCH_WINDOW 16
+#endif
+
+/**
+ * @brief Number of confirmed strides before a stream is read ahead.
+ */
+#ifndef __RMEM_CACHE_PREFETCH_THRESHOLD
+#define RMEM_CACHE_PREFETCH_THRESHOLD 2
+#endif
+
+/**
+ * @brief Number of misses that may be outstanding at once.
+ */
+#ifndef __RMEM_CACHE_MSHR_LENGTH
+#define RMEM_CACHE_MSHR_LENGTH 4
+#endif
+
+/**
+ * @brief Length of the write-behind queue (in pages).
+ */
+#ifndef __RMEM_CACHE_WB_LENGTH
+#define RMEM_CACHE_WB_LENGTH 8
+#endif
+
+/**
+ * @brief Size of the victim tier (in pages).
+ */
+#ifndef __RMEM_CACHE_VICTIM_SIZE
+#define RMEM_CACHE_VICTIM_SIZE (RMEM_CACHE_SIZE/2)
+#endif
+
+/**
+ * @brief Size of a chunk of the victim tier (in bytes).
+ */
+#define RMEM_CACHE_VICTIM_CHUNK_SIZE (RMEM_BLOCK_SIZE/8)
+
+/**
+ * @brief Number of chunks in a page.
+ */
+#define RMEM_CACHE_VICTIM_PAGE_CHUNKS (RMEM_BLOCK_SIZE/RMEM_CACHE_VICTIM_CHUNK_SIZE)
+
+/**
+ * @brief Number of chunks in the victim tier.
+ */
+#define RMEM_CACHE_VICTIM_NCHUNKS (RMEM_CACHE_VICTIM_SIZE*RMEM_CACHE_VICTIM_PAGE_CHUNKS)
+
+/**
+ * @brief Number of words in a page.
+ */
+#define RMEM_CACHE_VICTIM_PAGE_WORDS (RMEM_BLOCK_SIZE/sizeof(uint32_t))
+
+/**
+ * @brief Marks a run of a repeated word in a compressed page.
+ */
+#define RMEM_CACHE_VICTIM_RUN (1U << 31)
+
+/**
+ * @name States of a write-behind entry.
+ */
+/**@{*/
+#define RMEM_CACHE_WB_FREE    0 /**< Free                 */
+#define RMEM_CACHE_WB_PENDING 1 /**< Waiting to be written */
+#define RMEM_CACHE_WB_WRITING 2 /**< Being written         */
+/**@}*/
+
+/**
+ * @brief Cache slot.
+ *
+ * Slot metadata is kept apart from page frames, so that probing the
+ * cache touches a few dense cache lines rather than one page per slot.
+ */
+struct cache_slot
+{
+	rpage_t pgnum;  /**< Number of the cached page.     */
+	uint32_t age;   /**< Age.                           */
+	int ref_count;  /**< Reference count.               */
+	int flags;      /**< Flags.                         */
+	int hnext;      /**< Next slot in the lookup chain. */
+	int lprev;      /**< Previous line in recency list. */
+	int lnext;      /**< Next line in recency list.     */
+};
+
+/**
+ * @brief Cache slots.
+ */
+static struct cache_slot cache_slots[RMEM_CACHE_FRAMES] = {
+	[0 ... (RMEM_CACHE_FRAMES - 1)] = {
+		.pgnum = RMEM_NULL, .age = 0, .ref_count = 0, .flags = 0,
+		.hnext = RMEM_CACHE_NULL, .lprev = RMEM_CACHE_NULL, .lnext = RMEM_CACHE_NULL
+	}
+};
+
+/**
+ * @brief Page frames.
+ */
+static char cache_frames[RMEM_CACHE_FRAMES][RMEM_BLOCK_SIZE] ALIGN(PAGE_SIZE);
+
+/**
+ * @brief Page lookup table.
+ */
+static int cache_htab[RMEM_CACHE_HASH_LENGTH] = {
+	[0 ... (RMEM_CACHE_HASH_LENGTH - 1)] = RMEM_CACHE_NULL
+};
+
+/**
+ * @brief List of cache lines.
+ */
+struct cache_list
+{
+	int head;   /**< Most recently inserted line. */
+	int tail;   /**< Least recently used line.    */
+	int length; /**< Number of lines.             */
+};
+
+/**
+ * @brief Cache set.
+ *
+ * The lock of a set guards its lines: their slots, the contents of
+ * their frames and the lists in which they are linked.
+ */
+struct cache_set
+{
+	/**
+	 * @brief Recency list of lines.
+	 *
+	 * Lines that hold pages are linked here, most recently used
+	 * first, unless they sit in the A1in queue of the 2Q policy.
+	 */
+	struct cache_list lru;
+
+	struct cache_list a1in;   /**< A1in queue of the 2Q policy.  */
+	int nlines;               /**< Number of lines in use.       */
+	int hand;                 /**< Clock hand (way to inspect).  */
+	int nbusy;                /**< Number of lines being loaded. */
+	struct nanvix_mutex lock; /**< Lock.                         */
+};
+
+/**
+ * @brief Cache sets.
+ */
+static struct cache_set cache_sets[RMEM_CACHE_FRAMES] = {
+	[0 ... (RMEM_CACHE_FRAMES - 1)] = {
+		.lru = { RMEM_CACHE_NULL, RMEM_CACHE_NULL, 0 },
+		.a1in = { RMEM_CACHE_NULL, RMEM_CACHE_NULL, 0 },
+		.nlines = 0,
+		.hand = 0,
+		.nbusy = 0
+	}
+};
+
+/**
+ * @brief Cache lock.
+ *
+ * Guards the page lookup table, the ghost queue and the prefetcher.
+ * It is held for short lookups only, and it is taken
+ * after the lock of a set, never before. Page numbers of slots are
+ * changed only with both locks held, so either one is enough to
+ * read them.
+ */
+static struct nanvix_mutex cache_lock;
+
+/**
+ * @brief Statistics lock.
+ *
+ * Counters are updated with any other lock held, so this one is
+ * always taken last.
+ */
+static struct nanvix_mutex stats_lock;
+
+/**
+ * @brief Are cache locks initialized?
+ */
+static int cache_initialized = 0;
+
+/**
+ * @brief Length of the cache (in lines).
+ */
+static int cache_length = RMEM_CACHE_LENGTH;
+
+/**
+ * @brief Size of a cache line (in pages).
+ */
+static int cache_block_size = RMEM_CACHE_BLOCK_SIZE;
+
+/**
+ * @brief Associativity (number of lines in a set).
+ */
+static int cache_ways = RMEM_CACHE_WAYS;
+
+/**
+ * @brief A1out ghost queue of the 2Q policy.
+ *
+ * Remembers the numbers of pages recently evicted from A1in, so that a
+ * page that is referenced again shortly after is admitted straight
+ * into the main LRU list. One-time references of a sequential sweep
+ * thus never displace the hot working set.
+ */
+static struct
+{
+	struct
+	{
+		rpage_t pgnum; /**< Number of the evicted page.     */
+		int hnext;     /**< Next ghost in the lookup chain. */
+	} entries[RMEM_CACHE_2Q_KOUT_MAX];
+	int htab[RMEM_CACHE_HASH_LENGTH]; /**< Lookup table.       */
+	int next;                         /**< Next entry to reuse. */
+} cache_ghosts = {
+	.entries = {
+		[0 ... (RMEM_CACHE_2Q_KOUT_MAX - 1)] = { RMEM_NULL, RMEM_CACHE_NULL }
+	},
+	.htab = { [0 ... (RMEM_CACHE_HASH_LENGTH - 1)] = RMEM_CACHE_NULL },
+	.next = 0
+};
+
+/**
+ * @brief Access streams of the prefetcher.
+ *
+ * A stream follows accesses that fall close to each other. Once its
+ * stride is confirmed RMEM_CACHE_PREFETCH_THRESHOLD times in a row,
+ * the next lines of the stream are read ahead.
+ */
+static struct
+{
+	rpage_t last;   /**< Last page accessed.          */
+	int stride;     /**< Stride (in pages).           */
+	int confidence; /**< Number of confirmed strides. */
+	unsigned stamp; /**< Time of last access.         */
+} cache_streams[RMEM_CACHE_PREFETCH_STREAMS] = {
+	[0 ... (RMEM_CACHE_PREFETCH_STREAMS - 1)] = { RMEM_NULL, 0, 0, 0 }
+};
+
+/**
+ * @brief Remote pages allocated through the cache.
+ *
+ * The prefetcher never reads ahead pages that are not allocated.
+ */
+static bitmap_t cache_pages[RMEM_SERVERS_NUM][(RMEM_NUM_BLOCKS + BITMAP_WORD_LENGTH - 1)/BITMAP_WORD_LENGTH];
+
+/**
+ * @brief Remote pages that were never written.
+ *
+ * Remote memory hands out zeroed blocks, thus a miss on one of these
+ * pages zeroes its frame rather than reading the page. A page leaves
+ * the set as soon as it is written back. The lock is taken with any
+ * other lock held, like the statistics lock.
+ */
+static struct
+{
+	bitmap_t pages[RMEM_SERVERS_NUM][(RMEM_NUM_BLOCKS + BITMAP_WORD_LENGTH - 1)/BITMAP_WORD_LENGTH];
+	struct nanvix_mutex lock;
+} cache_zero;
+
+/**
+ * @brief Write-behind queue.
+ *
+ * Modified pages that are evicted are copied here and written back
+ * by the write-behind thread, so that a miss only pays for the read
+ * of the incoming page. Entries are drained in order. A page that is
+ * missed while pending is taken back from the queue. Writes that fail
+ * are counted and reported by nanvix_rcache_sync().
+ */
+static struct
+{
+	struct
+	{
+		rpage_t pgnum; /**< Number of the page (RMEM_NULL if cancelled). */
+		int state;     /**< State.                                        */
+	} entries[RMEM_CACHE_WB_LENGTH];
+	int head;                            /**< Next entry to write.         */
+	int tail;                            /**< Next entry to fill.          */
+	int length;                          /**< Number of queued entries.    */
+	int nerrors;                         /**< Number of failed writes.     */
+	int enabled;                         /**< Is write-behind enabled?     */
+	int shutdown;                        /**< Should the writer stop?      */
+	struct nanvix_mutex lock;            /**< Lock.                        */
+	struct nanvix_semaphore nfree;       /**< Number of free entries.      */
+	struct nanvix_semaphore npending;    /**< Number of queued entries.    */
+} cache_wb = {
+	.entries = {
+		[0 ... (RMEM_CACHE_WB_LENGTH - 1)] = { RMEM_NULL, RMEM_CACHE_WB_FREE }
+	},
+	.head = 0,
+	.tail = 0,
+	.length = 0,
+	.nerrors = 0,
+	.enabled = 0,
+	.shutdown = 0,
+};
+
+/**
+ * @brief Page frames of the write-behind queue.
+ */
+static char cache_wb_frames[RMEM_CACHE_WB_LENGTH][RMEM_BLOCK_SIZE] ALIGN(PAGE_SIZE);
+
+/**
+ * @brief Staging buffer of accesses that bypass the cache.
+ *
+ * Partial accesses that bypass the cache go through this buffer, so
+ * that they do not take a line. Its lock is taken after the lock of
+ * a set.
+ */
+static struct
+{
+	char frame[RMEM_BLOCK_SIZE] ALIGN(PAGE_SIZE); /**< Page frame. */
+	struct nanvix_mutex lock;                     /**< Lock.       */
+} cache_staging;
+
+/**
+ * @brief Prefetch hint queue.
+ *
+ * Pages that the application is about to access are queued here and
+ * loaded by the prefetcher thread, so that the application does not
+ * wait for them. Hints are dropped if the queue is full. The
+ * prefetcher stops the write-behind thread when it stops itself, since
+ * the lines it loads may evict modified pages.
+ */
+static struct
+{
+	rpage_t pages[RMEM_CACHE_HINT_LENGTH]; /**< Queued pages.                */
+	int head;                              /**< Next page to load.           */
+	int tail;                              /**< Next entry to fill.          */
+	int length;                            /**< Number of queued pages.      */
+	int busy;                              /**< Is a page being loaded?      */
+	int enabled;                           /**< Is the prefetcher running?   */
+	int shutdown;                          /**< Should the prefetcher stop?  */
+	struct nanvix_mutex lock;              /**< Lock.                        */
+	struct nanvix_semaphore npending;      /**< Number of queued pages.      */
+} cache_hints = {
+	.head = 0,
+	.tail = 0,
+	.length = 0,
+	.busy = 0,
+	.enabled = 0,
+	.shutdown = 0,
+};
+
+/**
+ * @brief Victim tier.
+ *
+ * Pages that are evicted, clean or modified, are compressed into a
+ * local pool, which a miss looks up before it reads remote memory.
+ * Modified pages are written back as usual. A clean page that was
+ * changed without being marked as modified may thus keep the change
+ * while it stays in the pool, so pages should be marked before they
+ * are changed. The pool is split into chunks, so that a page takes as
+ * many chunks as its compressed size requires. A copy is dropped when
+ * its page is loaded, evicted again or written to remote memory. When
+ * the pool is full, the oldest pages are dropped. The lock of the tier
+ * is taken after the locks of the cache.
+ */
+static struct
+{
+	struct
+	{
+		rpage_t pgnum;                             /**< Number of the page. */
+		unsigned age;                              /**< Time of insertion.  */
+		int size;                                  /**< Size (in words).    */
+		int nchunks;                               /**< Number of chunks.   */
+		int chunks[RMEM_CACHE_VICTIM_PAGE_CHUNKS]; /**< Chunks.             */
+		int hnext;                                 /**< Next in the chain.  */
+	} entries[RMEM_CACHE_VICTIM_NCHUNKS];
+
+	/**
+	 * @brief Lookup table.
+	 */
+	int htab[RMEM_CACHE_HASH_LENGTH];
+
+	/**
+	 * @brief Chunks in use.
+	 */
+	bitmap_t chunks[(RMEM_CACHE_VICTIM_NCHUNKS + BITMAP_WORD_LENGTH - 1)/BITMAP_WORD_LENGTH];
+
+	/**
+	 * @brief Compression buffer.
+	 */
+	uint32_t scratch[RMEM_CACHE_VICTIM_PAGE_WORDS];
+
+	int nfree;                /**< Number of free chunks. */
+	unsigned time;            /**< Discrete time.         */
+	int enabled;              /**< Is the tier enabled?   */
+	struct nanvix_mutex lock; /**< Lock.                  */
+} cache_victim = {
+	.entries = {
+		[0 ... (RMEM_CACHE_VICTIM_NCHUNKS - 1)] = { .pgnum = RMEM_NULL, .hnext = RMEM_CACHE_NULL }
+	},
+	.htab = { [0 ... (RMEM_CACHE_HASH_LENGTH - 1)] = RMEM_CACHE_NULL },
+	.nfree = RMEM_CACHE_VICTIM_NCHUNKS,
+	.time = 0,
+#ifdef __RMEM_CACHE_VICTIM
+	.enabled = 1,
+#else
+	.enabled = 0,
+#endif
+};
+
+/**
+ * @brief Chunks of the victim tier.
+ */
+static char cache_victim_pool[RMEM_CACHE_VICTIM_NCHUNKS][RMEM_CACHE_VICTIM_CHUNK_SIZE];
+
+/**
+ * @brief Miss status holding registers.
+ *
+ * A line that misses is linked in its set and flagged as busy, and
+ * then the lock of the set is released while its pages are read.
+ * Threads that miss on the same pages wait for that single fetch,
+ * and threads that hit other lines of the set are not blocked. If
+ * all registers are in use, a miss holds the lock of its set until
+ * the line is loaded.
+ */
+static struct
+{
+	struct
+	{
+		int line;                     /**< Line being loaded.        */
+		int nwaiters;                 /**< Number of waiting threads. */
+		struct nanvix_semaphore done; /**< Line loaded.              */
+	} entries[RMEM_CACHE_MSHR_LENGTH];
+	int length;                       /**< Number of misses in flight. */
+} cache_mshr = {
+	.entries = {
+		[0 ... (RMEM_CACHE_MSHR_LENGTH - 1)] = { .line = RMEM_CACHE_NULL, .nwaiters = 0 }
+	},
+	.length = 0
+};
+
+/**
+ * @brief Discrete cache time.
+ */
+static unsigned cache_time = 0;
+
+#ifdef __RMEM_CACHE_FIFO
+	static int cache_policy = RMEM_CACHE_FIFO;
+#elif defined(__RMEM_CACHE_LRU)
+	static int cache_policy = RMEM_CACHE_LRU;
+#elif defined(__RMEM_CACHE_AGING)
+	static int cache_policy = RMEM_CACHE_AGING;
+#elif defined(__RMEM_CACHE_LIFO)
+	static int cache_policy = RMEM_CACHE_LIFO;
+#elif defined(__RMEM_CACHE_CLOCK)
+	static int cache_policy = RMEM_CACHE_CLOCK;
+#elif defined(__RMEM_CACHE_2Q)
+	static int cache_policy = RMEM_CACHE_2Q;
+#elif defined(__RMEM_CACHE_ADAPTIVE)
+	static int cache_policy = RMEM_CACHE_ADAPTIVE;
+#else
+	static int cache_policy = RMEM_CACHE_FIFO;
+#endif
+
+#ifdef __RMEM_CACHE_PREFETCH
+	static int cache_prefetch = 1;
+#else
+	static int cache_prefetch = 0;
+#endif
+
+#ifdef __RMEM_CACHE_WRITE_BACK
+	static int write_num = RMEM_CACHE_WRITE_BACK;
+#elif defined(__RMEM_CACHE_WRITE_THROUGH)
+	static int write_num = RMEM_CACHE_WRITE_THROUGH;
+#else
+	static int write_num = RMEM_CACHE_WRITE_BACK;
+#endif
+
+/*============================================================================*
+ * nanvix_rcache_hash_insert()                                                *
+ *============================================================================*/
+
+/**
+ * @brief Inserts a slot in the page lookup table.
+ *
+ * @param idx Index of the target slot.
+ */
+static void nanvix_rcache_hash_insert(int idx)
+{
+	int h;
+
+	h = RMEM_CACHE_HASH(cache_slots[idx].pgnum);
+
+	cache_slots[idx].hnext = cache_htab[h];
+	cache_htab[h] = idx;
+}
+
+/*============================================================================*
+ * nanvix_rcache_hash_remove()                                                *
+ *============================================================================*/
+
+/**
+ * @brief Removes a slot from the page lookup table.
+ *
+ * @param idx Index of the target slot.
+ */
+static void nanvix_rcache_hash_remove(int idx)
+{
+	int *p;
+
+	for (p = &cache_htab[RMEM_CACHE_HASH(cache_slots[idx].pgnum)]; *p != RMEM_CACHE_NULL; p = &cache_slots[*p].hnext)
+	{
+		/* Found. */
+		if (*p == idx)
+		{
+			*p = cache_slots[idx].hnext;
+			break;
+		}
+	}
+
+	cache_slots[idx].hnext = RMEM_CACHE_NULL;
+}
+
+/*============================================================================*
+ * nanvix_rcache_line_set()                                                   *
+ *============================================================================*/
+
+/**
+ * @brief Gets the set of a cache line.
+ *
+ * @param idx Index of any slot of the target line.
+ *
+ * @returns The set of the target line.
+ */
+static inline struct cache_set *nanvix_rcache_line_set(int idx)
+{
+	return (&cache_sets[idx/(cache_ways*cache_block_size)]);
+}
+
+/*============================================================================*
+ * nanvix_rcache_page_set()                                                   *
+ *============================================================================*/
+
+/**
+ * @brief Gets the set in which a page should be loaded.
+ *
+ * Lines start at the requested page and span several pages, so the set
+ * is picked from the line-sized chunk of the address space in which
+ * the page falls.
+ *
+ * @param pgnum Number of the target page.
+ *
+ * @returns The number of the set for the target page.
+ */
+static inline int nanvix_rcache_page_set(rpage_t pgnum)
+{
+	pgnum /= cache_block_size;
+
+	return ((int)((pgnum ^ (pgnum >> RMEM_BLOCK_SERVER_SHIFT)) % (cache_length/cache_ways)));
+}
+
+/*============================================================================*
+ * nanvix_rcache_list_remove()                                                *
+ *============================================================================*/
+
+/**
+ * @brief Unlinks a line from a list.
+ *
+ * @param list Target list.
+ * @param idx  Index of the first slot of the target line.
+ */
+static void nanvix_rcache_list_remove(struct cache_list *list, int idx)
+{
+	if (cache_slots[idx].lprev != RMEM_CACHE_NULL)
+		cache_slots[cache_slots[idx].lprev].lnext = cache_slots[idx].lnext;
+	else
+		list->head = cache_slots[idx].lnext;
+
+	if (cache_slots[idx].lnext != RMEM_CACHE_NULL)
+		cache_slots[cache_slots[idx].lnext].lprev = cache_slots[idx].lprev;
+	else
+		list->tail = cache_slots[idx].lprev;
+
+	cache_slots[idx].lprev = RMEM_CACHE_NULL;
+	cache_slots[idx].lnext = RMEM_CACHE_NULL;
+	list->length--;
+}
+
+/*============================================================================*
+ * nanvix_rcache_list_push()                                                  *
+ *============================================================================*/
+
+/**
+ * @brief Links a line at the front of a list.
+ *
+ * @param list Target list.
+ * @param idx  Index of the first slot of the target line.
+ */
+static void nanvix_rcache_list_push(struct cache_list *list, int idx)
+{
+	cache_slots[idx].lprev = RMEM_CACHE_NULL;
+	cache_slots[idx].lnext = list->head;
+
+	if (list->head != RMEM_CACHE_NULL)
+		cache_slots[list->head].lprev = idx;
+	else
+		list->tail = idx;
+
+	list->head = idx;
+	list->length++;
+}
+
+/*============================================================================*
+ * nanvix_rcache_line_list()                                                  *
+ *============================================================================*/
+
+/**
+ * @brief Gets the list in which a line is linked.
+ *
+ * @param idx Index of the first slot of the target line.
+ *
+ * @returns The list in which the target line is linked.
+ */
+static struct cache_list *nanvix_rcache_line_list(int idx)
+{
+	struct cache_set *set;
+
+	set = nanvix_rcache_line_set(idx);
+
+	return ((cache_slots[idx].flags & RMEM_CACHE_SLOT_A1IN) ? &set->a1in : &set->lru);
+}
+
+/*============================================================================*
+ * nanvix_rcache_ghost_insert()                                               *
+ *============================================================================*/
+
+/**
+ * @brief Remembers a page evicted from the A1in queue.
+ *
+ * @param pgnum Number of the target page.
+ */
+static void nanvix_rcache_ghost_insert(rpage_t pgnum)
+{
+	int g;
+	int *p;
+
+	g = cache_ghosts.next;
+
+	/* Forget oldest ghost. */
+	if (cache_ghosts.entries[g].pgnum != RMEM_NULL)
+	{
+		for (p = &cache_ghosts.htab[RMEM_CACHE_HASH(cache_ghosts.entries[g].pgnum)]; *p != g; p = &cache_ghosts.entries[*p].hnext)
+			/* noop */ ;
+		*p = cache_ghosts.entries[g].hnext;
+	}
+
+	cache_ghosts.entries[g].pgnum = pgnum;
+	cache_ghosts.entries[g].hnext = cache_ghosts.htab[RMEM_CACHE_HASH(pgnum)];
+	cache_ghosts.htab[RMEM_CACHE_HASH(pgnum)] = g;
+
+	if (++cache_ghosts.next >= RMEM_CACHE_2Q_KOUT)
+		cache_ghosts.next = 0;
+}
+
+/*============================================================================*
+ * nanvix_rcache_ghost_remove()                                               *
+ *============================================================================*/
+
+/**
+ * @brief Forgets a page evicted from the A1in queue.
+ *
+ * @param pgnum Number of the target page.
+ *
+ * @returns If the page was remembered, non-zero is returned.
+ * Otherwise, zero is returned instead.
+ */
+static int nanvix_rcache_ghost_remove(rpage_t pgnum)
+{
+	int *p;
+
+	for (p = &cache_ghosts.htab[RMEM_CACHE_HASH(pgnum)]; *p != RMEM_CACHE_NULL; p = &cache_ghosts.entries[*p].hnext)
+	{
+		/* Found. */
+		if (cache_ghosts.entries[*p].pgnum == pgnum)
+		{
+			cache_ghosts.entries[*p].pgnum = RMEM_NULL;
+			*p = cache_ghosts.entries[*p].hnext;
+			return (1);
+		}
+	}
+
+	return (0);
+}
+
+/*============================================================================*
+ * nanvix_rcache_victim_compress()                                            *
+ *============================================================================*/
+
+/**
+ * @brief Compresses a page.
+ *
+ * Runs of a repeated word, such as zeroed or constant areas, are
+ * encoded as a header and the word. Other words are copied after a
+ * header that counts them.
+ *
+ * @param dst Target buffer.
+ * @param src Target page.
+ * @param max Size of @p dst (in words).
+ *
+ * @returns Upon successful completion, the size of the compressed page
+ * (in words) is returned. If it does not fit in @p max words, a
+ * negative error code is returned instead.
+ */
+static int nanvix_rcache_victim_compress(uint32_t *dst, const uint32_t *src, int max)
+{
+	int n = 0;
+	int literal = -1;
+
+	for (int i = 0, run; i < (int) RMEM_CACHE_VICTIM_PAGE_WORDS; i += run)
+	{
+		for (run = 1; (i + run) < (int) RMEM_CACHE_VICTIM_PAGE_WORDS; run++)
+		{
+			if (src[i + run] != src[i])
+				break;
+		}
+
+		/* Repeated word. */
+		if (run >= 3)
+		{
+			if ((n + 2) > max)
+				return (-ENOMEM);
+
+			dst[n++] = RMEM_CACHE_VICTIM_RUN | run;
+			dst[n++] = src[i];
+			literal = -1;
+			continue;
+		}
+
+		/* Start a new literal. */
+		if (literal < 0)
+		{
+			if ((n + 1) > max)
+				return (-ENOMEM);
+
+			literal = n;
+			dst[n++] = 0;
+		}
+
+		if ((n + 1) > max)
+			return (-ENOMEM);
+
+		dst[literal]++;
+		dst[n++] = src[i];
+		run = 1;
+	}
+
+	return (n);
+}
+
+/*============================================================================*
+ * nanvix_rcache_victim_decompress()                                          *
+ *============================================================================*/
+
+/**
+ * @brief Decompresses a page.
+ *
+ * @param dst  Target page.
+ * @param src  Compressed page.
+ * @param size Size of @p src (in words).
+ */
+static void nanvix_rcache_victim_decompress(uint32_t *dst, const uint32_t *src, int size)
+{
+	uint32_t count;
+
+	for (int i = 0, j = 0; i < size; /* noop */)
+	{
+		count = src[i] & ~RMEM_CACHE_VICTIM_RUN;
+
+		/* Repeated word. */
+		if (src[i++] & RMEM_CACHE_VICTIM_RUN)
+		{
+			for (uint32_t k = 0; k < count; k++)
+				dst[j++] = src[i];
+			i++;
+		}
+
+		/* Literal. */
+		else
+		{
+			for (uint32_t k = 0; k < count; k++)
+				dst[j++] = src[i++];
+		}
+	}
+}
+
+/*============================================================================*
+ * nanvix_rcache_victim_drop()                                                *
+ *============================================================================*/
+
+/**
+ * @brief Drops a page from the victim tier.
+ *
+ * The caller should hold the lock of the victim tier.
+ *
+ * @param e Index of the target entry.
+ */
+static void nanvix_rcache_victim_drop(int e)
+{
+	int *p;
+
+	for (p = &cache_victim.htab[RMEM_CACHE_HASH(cache_victim.entries[e].pgnum)]; *p != e; p = &cache_victim.entries[*p].hnext)
+		/* noop */ ;
+	*p = cache_victim.entries[e].hnext;
+
+	for (int i = 0; i < cache_victim.entries[e].nchunks; i++)
+		bitmap_clear(cache_victim.chunks, cache_victim.entries[e].chunks[i]);
+
+	cache_victim.nfree += cache_victim.entries[e].nchunks;
+	cache_victim.entries[e].pgnum = RMEM_NULL;
+	cache_victim.entries[e].nchunks = 0;
+}
+
+/*============================================================================*
+ * nanvix_rcache_victim_search()                                              *
+ *============================================================================*/
+
+/**
+ * @brief Searches for a page in the victim tier.
+ *
+ * The caller should hold the lock of the victim tier.
+ *
+ * @param pgnum Number of the target page.
+ *
+ * @returns If the page is found, the index of its entry is returned.
+ * Otherwise, RMEM_CACHE_NULL is returned instead.
+ */
+static int nanvix_rcache_victim_search(rpage_t pgnum)
+{
+	for (int e = cache_victim.htab[RMEM_CACHE_HASH(pgnum)]; e != RMEM_CACHE_NULL; e = cache_victim.entries[e].hnext)
+	{
+		/* Found. */
+		if (cache_victim.entries[e].pgnum == pgnum)
+			return (e);
+	}
+
+	return (RMEM_CACHE_NULL);
+}
+
+/*============================================================================*
+ * nanvix_rcache_victim_store()                                               *
+ *============================================================================*/
+
+/**
+ * @brief Stores an evicted page in the victim tier.
+ *
+ * Pages that do not compress to less than a page are not stored. Any
+ * previous copy of the page is dropped.
+ *
+ * @param pgnum Number of the target page.
+ * @param frame Page frame of the target page.
+ */
+static void nanvix_rcache_victim_store(rpage_t pgnum, const void *frame)
+{
+	int e;
+	int size;
+	int nchunks;
+	int oldest;
+
+	nanvix_mutex_lock(&cache_victim.lock);
+
+		/* Tier is disabled, thus empty. */
+		if (!cache_victim.enabled)
+			goto out;
+
+		/* Drop outdated copy. */
+		if ((e = nanvix_rcache_victim_search(pgnum)) != RMEM_CACHE_NULL)
+			nanvix_rcache_victim_drop(e);
+
+		/* Page does not compress. */
+		size = nanvix_rcache_victim_compress(
+			cache_victim.scratch,
+			frame,
+			((RMEM_CACHE_VICTIM_PAGE_CHUNKS - 1)*RMEM_CACHE_VICTIM_CHUNK_SIZE)/sizeof(uint32_t)
+		);
+		if (size < 0)
+			goto out;
+
+		nchunks = (size*sizeof(uint32_t) + RMEM_CACHE_VICTIM_CHUNK_SIZE - 1)/RMEM_CACHE_VICTIM_CHUNK_SIZE;
+
+		/* Make room, dropping the oldest pages. */
+		while (1)
+		{
+			e = RMEM_CACHE_NULL;
+			oldest = RMEM_CACHE_NULL;
+			for (int i = 0; i < RMEM_CACHE_VICTIM_NCHUNKS; i++)
+			{
+				if (cache_victim.entries[i].pgnum == RMEM_NULL)
+					e = i;
+				else if ((oldest == RMEM_CACHE_NULL) || (cache_victim.entries[i].age < cache_victim.entries[oldest].age))
+					oldest = i;
+			}
+
+			if ((e != RMEM_CACHE_NULL) && (cache_victim.nfree >= nchunks))
+				break;
+
+			nanvix_rcache_victim_drop(oldest);
+		}
+
+		cache_victim.entries[e].pgnum = pgnum;
+		cache_victim.entries[e].hnext = cache_victim.htab[RMEM_CACHE_HASH(pgnum)];
+		cache_victim.htab[RMEM_CACHE_HASH(pgnum)] = e;
+		cache_victim.entries[e].age = cache_victim.time++;
+		cache_victim.entries[e].size = size;
+		cache_victim.entries[e].nchunks = nchunks;
+		for (int i = 0; i < nchunks; i++)
+		{
+			int chunk = bitmap_first_free(cache_victim.chunks, sizeof(cache_victim.chunks));
+
+			bitmap_set(cache_victim.chunks, chunk);
+			cache_victim.entries[e].chunks[i] = chunk;
+			umemcpy(
+				cache_victim_pool[chunk],
+				&((char *) cache_victim.scratch)[i*RMEM_CACHE_VICTIM_CHUNK_SIZE],
+				RMEM_CACHE_VICTIM_CHUNK_SIZE
+			);
+		}
+		cache_victim.nfree -= nchunks;
+
+out:
+	nanvix_mutex_unlock(&cache_victim.lock);
+}
+
+/*============================================================================*
+ * nanvix_rcache_victim_load()                                                *
+ *============================================================================*/
+
+/**
+ * @brief Loads a page from the victim tier.
+ *
+ * The page leaves the tier, since it is cached from now on.
+ *
+ * @param pgnum Number of the target page.
+ * @param frame Target page frame.
+ *
+ * @returns Non-zero if the page was loaded and zero otherwise.
+ */
+static int nanvix_rcache_victim_load(rpage_t pgnum, void *frame)
+{
+	int e = RMEM_CACHE_NULL;
+
+	nanvix_mutex_lock(&cache_victim.lock);
+
+		/* Tier is disabled, thus empty. */
+		if (cache_victim.enabled && ((e = nanvix_rcache_victim_search(pgnum)) != RMEM_CACHE_NULL))
+		{
+			for (int i = 0; i < cache_victim.entries[e].nchunks; i++)
+			{
+				umemcpy(
+					&((char *) cache_victim.scratch)[i*RMEM_CACHE_VICTIM_CHUNK_SIZE],
+					cache_victim_pool[cache_victim.entries[e].chunks[i]],
+					RMEM_CACHE_VICTIM_CHUNK_SIZE
+				);
+			}
+
+			nanvix_rcache_victim_decompress(frame, cache_victim.scratch, cache_victim.entries[e].size);
+			nanvix_rcache_victim_drop(e);
+		}
+
+	nanvix_mutex_unlock(&cache_victim.lock);
+
+	return (e != RMEM_CACHE_NULL);
+}
+
+/*============================================================================*
+ * nanvix_rcache_victim_remove()                                              *
+ *============================================================================*/
+
+/**
+ * @brief Removes a page from the victim tier.
+ *
+ * @param pgnum Number of the target page.
+ */
+static void nanvix_rcache_victim_remove(rpage_t pgnum)
+{
+	int e;
+
+	nanvix_mutex_lock(&cache_victim.lock);
+
+		/* Tier is disabled, thus empty. */
+		if (cache_victim.enabled && ((e = nanvix_rcache_victim_search(pgnum)) != RMEM_CACHE_NULL))
+			nanvix_rcache_victim_drop(e);
+
+	nanvix_mutex_unlock(&cache_victim.lock);
+}
+
+/*============================================================================*
+ * nanvix_rcache_victim_flush()                                               *
+ *============================================================================*/
+
+/**
+ * @brief Drops all pages from the victim tier.
+ *
+ * The caller should hold the lock of the victim tier.
+ */
+static void nanvix_rcache_victim_flush(void)
+{
+	for (int e = 0; e < RMEM_CACHE_VICTIM_NCHUNKS; e++)
+	{
+		if (cache_victim.entries[e].pgnum != RMEM_NULL)
+			nanvix_rcache_victim_drop(e);
+	}
+}
+
+/*============================================================================*
+ * nanvix_rcache_line_invalidate()                                            *
+ *============================================================================*/
+
+/**
+ * @brief Drops all pages of a cache line.
+ *
+ * @param idx Index of the first slot of the target line.
+ */
+static void nanvix_rcache_line_invalidate(int idx)
+{
+	/* Line is in use. */
+	if (cache_slots[idx].pgnum != RMEM_NULL)
+	{
+		nanvix_rcache_list_remove(nanvix_rcache_line_list(idx), idx);
+		nanvix_rcache_line_set(idx)->nlines--;
+	}
+
+	for (int i = idx; i < idx + cache_block_size; i++)
+	{
+		if (cache_slots[i].pgnum == RMEM_NULL)
+			continue;
+
+		nanvix_rcache_hash_remove(i);
+		cache_slots[i].pgnum = RMEM_NULL;
+		cache_slots[i].ref_count = 0;
+		cache_slots[i].flags = 0;
+	}
+}
+
+/*============================================================================*
+ * nanvix_rcache_reset()                                                      *
+ *============================================================================*/
+
+/**
+ * @brief Drops all pages and forgets all history of the cache.
+ *
+ * The caller should hold all cache locks.
+ */
+static void nanvix_rcache_reset(void)
+{
+	for (int i = 0; i < RMEM_CACHE_FRAMES; i++)
+	{
+		cache_slots[i].pgnum = RMEM_NULL;
+		cache_slots[i].age = 0;
+		cache_slots[i].ref_count = 0;
+		cache_slots[i].flags = 0;
+		cache_slots[i].hnext = RMEM_CACHE_NULL;
+		cache_slots[i].lprev = RMEM_CACHE_NULL;
+		cache_slots[i].lnext = RMEM_CACHE_NULL;
+	}
+
+	for (int i = 0; i < RMEM_CACHE_HASH_LENGTH; i++)
+		cache_htab[i] = RMEM_CACHE_NULL;
+
+	for (int i = 0; i < RMEM_CACHE_FRAMES; i++)
+	{
+		cache_sets[i].lru.head = RMEM_CACHE_NULL;
+		cache_sets[i].lru.tail = RMEM_CACHE_NULL;
+		cache_sets[i].lru.length = 0;
+		cache_sets[i].a1in.head = RMEM_CACHE_NULL;
+		cache_sets[i].a1in.tail = RMEM_CACHE_NULL;
+		cache_sets[i].a1in.length = 0;
+		cache_sets[i].nlines = 0;
+		cache_sets[i].hand = 0;
+		cache_sets[i].nbusy = 0;
+	}
+
+	for (int i = 0; i < RMEM_CACHE_2Q_KOUT_MAX; i++)
+		cache_ghosts.entries[i].pgnum = RMEM_NULL;
+	for (int i = 0; i < RMEM_CACHE_HASH_LENGTH; i++)
+		cache_ghosts.htab[i] = RMEM_CACHE_NULL;
+	cache_ghosts.next = 0;
+
+	for (int i = 0; i < RMEM_CACHE_PREFETCH_STREAMS; i++)
+	{
+		cache_streams[i].last = RMEM_NULL;
+		cache_streams[i].stride = 0;
+		cache_streams[i].confidence = 0;
+		cache_streams[i].stamp = 0;
+	}
+}
+
+/*============================================================================*
+ * nanvix_rcache_lock_all()                                                   *
+ *============================================================================*/
+
+/**
+ * @brief Locks the whole cache.
+ *
+ * Set locks are taken in order, so that callers do not deadlock with
+ * each other. Outstanding misses are waited for, since their lines
+ * are written to without holding any lock.
+ */
+static void nanvix_rcache_lock_all(void)
+{
+	while (1)
+	{
+		for (int i = 0; i < RMEM_CACHE_FRAMES; i++)
+			nanvix_mutex_lock(&cache_sets[i].lock);
+		nanvix_mutex_lock(&cache_lock);
+
+		/* No miss is outstanding. */
+		if (cache_mshr.length == 0)
+			return;
+
+		nanvix_mutex_unlock(&cache_lock);
+		for (int i = RMEM_CACHE_FRAMES - 1; i >= 0; i--)
+			nanvix_mutex_unlock(&cache_sets[i].lock);
+
+		kthread_yield();
+	}
+}
+
+/*============================================================================*
+ * nanvix_rcache_unlock_all()                                                 *
+ *============================================================================*/
+
+/**
+ * @brief Unlocks the whole cache.
+ */
+static void nanvix_rcache_unlock_all(void)
+{
+	nanvix_mutex_unlock(&cache_lock);
+	for (int i = RMEM_CACHE_FRAMES - 1; i >= 0; i--)
+		nanvix_mutex_unlock(&cache_sets[i].lock);
+}
+
+/*============================================================================*
+ * nanvix_rcache_clean()                                                      *
+ *============================================================================*/
+
+/**
+ * @brief Cleans the cache.
+ */
+void nanvix_rcache_clean(void)
+{
+	nanvix_rcache_lock_all();
+
+		nanvix_rcache_reset();
+
+		nanvix_mutex_lock(&cache_victim.lock);
+			nanvix_rcache_victim_flush();
+		nanvix_mutex_unlock(&cache_victim.lock);
+
+	nanvix_rcache_unlock_all();
+}
+
+/*============================================================================*
+ * nanvix_rcache_page_search()                                                *
+ *============================================================================*/
+
+/**
+ * @brief Searches for a page in the cache.
+ *
+ * The caller should hold the cache lock.
+ *
+ * @param pgnum Number of the target page.
+ *
+ * @returns Upon successful completion, the page index is
+ * returned. Upon failure a negative error code is returned instead.
+ */
+static int nanvix_rcache_page_search(rpage_t pgnum)
+{
+	cache_time++;
+
+	for (int i = cache_htab[RMEM_CACHE_HASH(pgnum)]; i != RMEM_CACHE_NULL; i = cache_slots[i].hnext)
+	{
+		/* Found. */
+		if (cache_slots[i].pgnum == pgnum)
+			return (i);
+	}
+
+	return (-EFAULT);
+}
+
+/*============================================================================*
+ * nanvix_update_aging()                                                      *
+ *============================================================================*/
+
+/**
+ * @brief Ages the lines of a set upon a reference.
+ *
+ * The counter of every line of the set is shifted right, and the top
+ * bit of the counter of the referenced line is set, so that lines that
+ * were not referenced lately have the smallest counters.
+ *
+ * @param set  Number of the target set.
+ * @param line Index of the first slot of the referenced line.
+ */
+static void nanvix_update_aging(int set, int line)
+{
+	uint32_t age;
+	int base;
+
+	base = set*cache_ways*cache_block_size;
+	for (int i = base; i < base + cache_ways*cache_block_size; i += cache_block_size)
+	{
+		age = ((uint32_t) cache_slots[i].age) >> 1;
+		if (i == line)
+			age |= 1u << 31;
+		cache_slots[i].age = age;
+	}
+}
+
+/*============================================================================*
+ * nanvix_rcache_age_update_lru()                                             *
+ *============================================================================*/
+
+/**
+ * @brief Updates the age of a cache line upon a hit.
+ *
+ * @param idx Index of the hit slot.
+ *
+ * @returns Upon successful completion, zero is returned. Upon
+ * failure a negative error code is returned instead.
+ */
+static int nanvix_rcache_age_update_lru(int idx)
+{
+	int line;
+
+	line = idx - (idx%cache_block_size);
+
+	/*
+	 * Keep the recency list up to date regardless of the
+	 * policy, so that switching to LRU at runtime is sound.
+	 * Under 2Q, hits on A1in are correlated references and
+	 * do not promote the line.
+	 */
+	if (!(cache_slots[line].flags & RMEM_CACHE_SLOT_A1IN))
+	{
+		nanvix_rcache_list_remove(&nanvix_rcache_line_set(line)->lru, line);
+		nanvix_rcache_list_push(&nanvix_rcache_line_set(line)->lru, line);
+	}
+	cache_slots[line].flags |= RMEM_CACHE_SLOT_REF;
+
+	if (cache_policy == RMEM_CACHE_AGING)
+		nanvix_update_aging(line/(cache_ways*cache_block_size), line);
+
+	return (0);
+}
+
+/*============================================================================*
+ * nanvix_rcache_age_update()                                                 *
+ *============================================================================*/
+
+/**
+ * @brief Sets the age of a line that was just loaded.
+ *
+ * The caller should hold the cache lock.
+ *
+ * @param idx Index of the first slot of the target line.
+ */
+static void nanvix_rcache_age_update(int idx)
+{
+	if (cache_policy == RMEM_CACHE_AGING)
+		nanvix_update_aging(idx/(cache_ways*cache_block_size), idx);
+	else
+		cache_slots[idx].age = cache_time;
+}
+
+/*============================================================================*
+ * nanvix_rcache_line_is_pinned()                                             *
+ *============================================================================*/
+
+/**
+ * @brief Asserts whether or not a cache line is in use.
+ *
+ * A thread that gets a page accesses its frame without holding any
+ * lock, until it puts the page back. Lines in use are thus never
+ * evicted.
+ *
+ * @param idx Index of the first slot of the target line.
+ *
+ * @returns Non-zero if the line is in use and zero otherwise.
+ */
+static int nanvix_rcache_line_is_pinned(int idx)
+{
+	for (int i = idx; i < idx + cache_block_size; i++)
+	{
+		if (cache_slots[i].ref_count > 0)
+			return (1);
+	}
+
+	return (0);
+}
+
+/*============================================================================*
+ * nanvix_rcache_line_is_valid()                                              *
+ *============================================================================*/
+
+/**
+ * @brief Asserts whether or not a cache line holds any page.
+ *
+ * @param idx Index of the first slot of the target line.
+ *
+ * @returns Non-zero if the line holds a page and zero otherwise.
+ */
+static int nanvix_rcache_line_is_valid(int idx)
+{
+	for (int i = idx; i < idx + cache_block_size; i++)
+	{
+		if (cache_slots[i].pgnum != RMEM_NULL)
+			return (1);
+	}
+
+	return (0);
+}
+
+/*============================================================================*
+ * nanvix_rcache_line_is_busy()                                               *
+ *============================================================================*/
+
+/**
+ * @brief Asserts whether or not a cache line is being loaded.
+ *
+ * Busy lines are owned by the thread that loads them, thus they are
+ * never evicted, and their slots are not inspected by other threads.
+ *
+ * @param idx Index of the first slot of the target line.
+ *
+ * @returns Non-zero if the line is busy and zero otherwise.
+ */
+static inline int nanvix_rcache_line_is_busy(int idx)
+{
+	return (cache_slots[idx].flags & RMEM_CACHE_SLOT_BUSY);
+}
+
+/*============================================================================*
+ * nanvix_rcache_list_victim()                                                *
+ *============================================================================*/
+
+/**
+ * @brief Searches for the least recently used line that may be evicted.
+ *
+ * @param list Target list.
+ *
+ * @returns The index of the first slot of the line, or RMEM_CACHE_NULL
+ * if no line of the list may be evicted.
+ */
+static int nanvix_rcache_list_victim(struct cache_list *list)
+{
+	for (int idx = list->tail; idx != RMEM_CACHE_NULL; idx = cache_slots[idx].lprev)
+	{
+		if (!nanvix_rcache_line_is_busy(idx) && !nanvix_rcache_line_is_pinned(idx))
+			return (idx);
+	}
+
+	return (RMEM_CACHE_NULL);
+}
+
+/*============================================================================*
+ * nanvix_rcache_line_is_dirty()                                              *
+ *============================================================================*/
+
+/**
+ * @brief Asserts whether or not a cache line holds modified pages.
+ *
+ * @param idx Index of the first slot of the target line.
+ *
+ * @returns Non-zero if the line is dirty and zero otherwise.
+ */
+static int nanvix_rcache_line_is_dirty(int idx)
+{
+	for (int i = idx; i < idx + cache_block_size; i++)
+	{
+		if (cache_slots[i].flags & RMEM_CACHE_SLOT_DIRTY)
+			return (1);
+	}
+
+	return (0);
+}
+
+/*============================================================================*
+ * nanvix_rcache_zero_clear()                                                 *
+ *============================================================================*/
+
+/**
+ * @brief Notes that a remote page is about to be written.
+ *
+ * @param pgnum Number of the target page.
+ */
+static void nanvix_rcache_zero_clear(rpage_t pgnum)
+{
+	nanvix_mutex_lock(&cache_zero.lock);
+		bitmap_clear(cache_zero.pages[RMEM_BLOCK_SERVER(pgnum)], RMEM_BLOCK_NUM(pgnum));
+	nanvix_mutex_unlock(&cache_zero.lock);
+}
+
+/*============================================================================*
+ * nanvix_rcache_zero_check()                                                 *
+ *============================================================================*/
+
+/**
+ * @brief Asserts whether a remote page was never written.
+ *
+ * @param pgnum Number of the target page.
+ *
+ * @returns If @p pgnum holds only zeros in remote memory, one is
+ * returned. Otherwise, zero is returned instead.
+ */
+static int nanvix_rcache_zero_check(rpage_t pgnum)
+{
+	int zero;
+
+	nanvix_mutex_lock(&cache_zero.lock);
+		zero = bitmap_check_bit(cache_zero.pages[RMEM_BLOCK_SERVER(pgnum)], RMEM_BLOCK_NUM(pgnum));
+	nanvix_mutex_unlock(&cache_zero.lock);
+
+	return (zero != 0);
+}
+
+/*============================================================================*
+ * nanvix_rcache_wb_enqueue()                                                 *
+ *============================================================================*/
+
+/**
+ * @brief Hands a modified page over to the write-behind thread.
+ *
+ * The caller blocks only while the queue is full. Whether the thread
+ * runs is checked with the lock of the queue held, since the thread
+ * stops once it finds the queue drained.
+ *
+ * @param pgnum Number of the target page.
+ * @param frame Contents of the target page.
+ *
+ * @returns Upon successful completion, zero is returned. If
+ * write-behind is disabled, a negative error code is returned instead.
+ */
+static int nanvix_rcache_wb_enqueue(rpage_t pgnum, const void *frame)
+{
+	int e;
+	int enabled;
+
+	nanvix_mutex_lock(&cache_wb.lock);
+		enabled = cache_wb.enabled;
+	nanvix_mutex_unlock(&cache_wb.lock);
+
+	/* Nothing to do. */
+	if (!enabled)
+		return (-EAGAIN);
+
+	uassert(nanvix_semaphore_down(&cache_wb.nfree) == 0);
+
+	nanvix_mutex_lock(&cache_wb.lock);
+
+		/* Write-behind thread stopped meanwhile. */
+		if (!cache_wb.enabled)
+		{
+			nanvix_mutex_unlock(&cache_wb.lock);
+			uassert(nanvix_semaphore_up(&cache_wb.nfree) == 0);
+			return (-EAGAIN);
+		}
+
+		e = cache_wb.tail;
+		cache_wb.tail = (cache_wb.tail + 1) % RMEM_CACHE_WB_LENGTH;
+		cache_wb.length++;
+
+		umemcpy(cache_wb_frames[e], frame, RMEM_BLOCK_SIZE);
+		cache_wb.entries[e].pgnum = pgnum;
+		cache_wb.entries[e].state = RMEM_CACHE_WB_PENDING;
+
+	nanvix_mutex_unlock(&cache_wb.lock);
+
+	uassert(nanvix_semaphore_up(&cache_wb.npending) == 0);
+
+	return (0);
+}
+
+/*============================================================================*
+ * nanvix_rcache_wb_lookup()                                                  *
+ *============================================================================*/
+
+/**
+ * @brief Looks up a page in the write-behind queue.
+ *
+ * If the page is being written, the caller waits for the write to
+ * complete, so that remote memory is up to date when this function
+ * returns.
+ *
+ * @param pgnum  Number of the target page.
+ * @param frame  Store location for the contents of the page (may be
+ * NULL).
+ * @param cancel Should the page be taken back from the queue?
+ *
+ * @returns If the page was pending, one is returned and its
+ * contents are copied to @p frame. Otherwise, zero is returned.
+ */
+static int nanvix_rcache_wb_lookup(rpage_t pgnum, void *frame, int cancel)
+{
+	int ret = 0;
+	int busy;
+
+	do
+	{
+		busy = 0;
+
+		nanvix_mutex_lock(&cache_wb.lock);
+
+			for (int e = 0; cache_wb.enabled && (e < RMEM_CACHE_WB_LENGTH); e++)
+			{
+				if (cache_wb.entries[e].pgnum != pgnum)
+					continue;
+
+				if (cache_wb.entries[e].state == RMEM_CACHE_WB_WRITING)
+				{
+					busy = 1;
+					break;
+				}
+
+				if (frame != NULL)
+					umemcpy(frame, cache_wb_frames[e], RMEM_BLOCK_SIZE);
+				if (cancel)
+					cache_wb.entries[e].pgnum = RMEM_NULL;
+				ret = 1;
+			}
+
+		nanvix_mutex_unlock(&cache_wb.lock);
+
+		if (busy)
+			kthread_yield();
+	} while (busy);
+
+	return (ret);
+}
+
+/*============================================================================*
+ * nanvix_rcache_wb_cancel()                                                  *
+ *============================================================================*/
+
+/**
+ * @brief Takes a page back from the write-behind queue.
+ *
+ * @param pgnum Number of the target page.
+ * @param frame Store location for the contents of the page (may be
+ * NULL).
+ *
+ * @returns If the page was pending, one is returned and its
+ * contents are copied to @p frame. Otherwise, zero is returned.
+ */
+static int nanvix_rcache_wb_cancel(rpage_t pgnum, void *frame)
+{
+	return (nanvix_rcache_wb_lookup(pgnum, frame, 1));
+}
+
+/*============================================================================*
+ * nanvix_rcache_line_writeback()                                             *
+ *============================================================================*/
+
+/**
+ * @brief Writes modified pages of a cache line back to remote memory.
+ *
+ * Clean pages hold the same data as remote memory, so evicting them
+ * costs no transfer at all. Modified pages are queued for write-behind,
+ * if it is enabled. The caller drops the line afterwards, thus all of
+ * its pages are kept in the victim tier.
+ *
+ * @param idx Index of the first slot of the target line.
+ *
+ * @returns Upon successful completion, zero is returned. Upon
+ * failure a negative error code is returned instead.
+ */
+static int nanvix_rcache_line_writeback(int idx)
+{
+	for (int i = idx; i < idx + cache_block_size; i++)
+	{
+		/* Page is cached in another line. */
+		if (cache_slots[i].pgnum == RMEM_NULL)
+			continue;
+
+		/* Nothing to write. */
+		if (!(cache_slots[i].flags & RMEM_CACHE_SLOT_DIRTY))
+		{
+			nanvix_rcache_victim_store(cache_slots[i].pgnum, cache_frames[i]);
+			continue;
+		}
+
+		nanvix_rcache_zero_clear(cache_slots[i].pgnum);
+
+		if ((nanvix_rcache_wb_enqueue(cache_slots[i].pgnum, cache_frames[i]) < 0) &&
+			(nanvix_rmem_write(cache_slots[i].pgnum, cache_frames[i]) != RMEM_BLOCK_SIZE))
+			return (-EFAULT);
+
+		cache_slots[i].flags &= ~RMEM_CACHE_SLOT_DIRTY;
+
+		nanvix_rcache_victim_store(cache_slots[i].pgnum, cache_frames[i]);
+
+		nanvix_mutex_lock(&stats_lock);
+			stats.nwritebacks++;
+			stats.nwritten += RMEM_BLOCK_SIZE;
+		nanvix_mutex_unlock(&stats_lock);
+	}
+
+	return (0);
+}
+
+/*============================================================================*
+ * nanvix_rcache_writeback_all()                                              *
+ *============================================================================*/
+
+/**
+ * @brief Writes all modified pages back to remote memory.
+ *
+ * @returns Upon successful completion, zero is returned. Upon
+ * failure a negative error code is returned instead.
+ */
+static int nanvix_rcache_writeback_all(void)
+{
+	for (int i = 0; i < cache_length*cache_block_size; i += cache_block_size)
+	{
+		if (nanvix_rcache_line_writeback(i) < 0)
+			return (-EFAULT);
+	}
+
+	return (0);
+}
+
+/*============================================================================*
+ * nanvix_rcache_is_pinned()                                                  *
+ *============================================================================*/
+
+/**
+ * @brief Asserts whether or not any cache line is in use.
+ *
+ * The cache may be emptied only if no thread holds a page, nor loads
+ * one into a line. The caller should hold the locks of all sets.
+ *
+ * @returns Non-zero if a line is in use and zero otherwise.
+ */
+static int nanvix_rcache_is_pinned(void)
+{
+	for (int i = 0; i < cache_length*cache_block_size; i += cache_block_size)
+	{
+		if (nanvix_rcache_line_is_busy(i) || nanvix_rcache_line_is_pinned(i))
+			return (1);
+	}
+
+	return (0);
+}
+
+/*============================================================================*
+ * nanvix_rcache_filter_record()                                              *
+ *============================================================================*/
+
+/**
+ * @brief Counts an access in the admission filter.
+ *
+ * The caller should hold the statistics lock.
+ *
+ * @param pgnum Number of the accessed page.
+ */
+static void nanvix_rcache_filter_record(rpage_t pgnum)
+{
+	uint8_t *count;
+
+	/* Nothing to do. */
+	if (!cache_filter.enabled)
+		return;
+
+	for (int i = 0; i < RMEM_CACHE_FILTER_DEPTH; i++)
+	{
+		count = &cache_filter.counts[i][((((uint32_t)pgnum)*cache_filter_seeds[i]) >> 16) % RMEM_CACHE_FILTER_WIDTH];
+		if (*count < RMEM_CACHE_FILTER_MAX)
+			(*count)++;
+	}
+
+	/* Age counts. */
+	if (++cache_filter.naccesses == RMEM_CACHE_FILTER_SAMPLE)
+	{
+		for (int i = 0; i < RMEM_CACHE_FILTER_DEPTH; i++)
+		{
+			for (int j = 0; j < RMEM_CACHE_FILTER_WIDTH; j++)
+				cache_filter.counts[i][j] >>= 1;
+		}
+		cache_filter.naccesses /= 2;
+	}
+}
+
+/*============================================================================*
+ * nanvix_rcache_filter_estimate()                                            *
+ *============================================================================*/
+
+/**
+ * @brief Estimates how often a page was accessed.
+ *
+ * The caller should hold the statistics lock.
+ *
+ * @param pgnum Number of the target page.
+ *
+ * @returns The smallest count of @p pgnum in the sketch.
+ */
+static int nanvix_rcache_filter_estimate(rpage_t pgnum)
+{
+	int count;
+	int estimate = RMEM_CACHE_FILTER_MAX;
+
+	for (int i = 0; i < RMEM_CACHE_FILTER_DEPTH; i++)
+	{
+		count = cache_filter.counts[i][((((uint32_t)pgnum)*cache_filter_seeds[i]) >> 16) % RMEM_CACHE_FILTER_WIDTH];
+		if (count < estimate)
+			estimate = count;
+	}
+
+	return (estimate);
+}
+
+/*============================================================================*
+ * nanvix_rcache_filter_admit()                                               *
+ *============================================================================*/
+
+/**
+ * @brief Asserts whether a missing page should evict a cached one.
+ *
+ * The caller should hold the statistics lock. The miss on @p pgnum is
+ * not counted yet, thus it is added to the estimate.
+ *
+ * @param pgnum  Number of the missing page.
+ * @param victim Number of the page that would be evicted.
+ *
+ * @returns If @p pgnum should be admitted, one is returned. Otherwise,
+ * zero is returned instead.
+ */
+static int nanvix_rcache_filter_admit(rpage_t pgnum, rpage_t victim)
+{
+	/* Nothing to do. */
+	if (!cache_filter.enabled)
+		return (1);
+
+	return ((nanvix_rcache_filter_estimate(pgnum) + 1) > nanvix_rcache_filter_estimate(victim));
+}
+
+/*============================================================================*
+ * nanvix_rcache_free_line()                                                  *
+ *============================================================================*/
+
+/**
+ * @brief Searches for a free cache line in a set.
+ *
+ * @param set Number of the target set.
+ *
+ * @returns If the set has space, the index of the first slot of a
+ * free line is returned. Otherwise, a negative error code is
+ * returned instead.
+ */
+static int nanvix_rcache_free_line(int set)
+{
+	int base;
+
+	/* Set is full. */
+	if (cache_sets[set].nlines == cache_ways)
+		return (-ENOMEM);
+
+	base = set*cache_ways*cache_block_size;
+	for (int i = 0; i < cache_ways; i++)
+	{
+		if (cache_slots[base + i*cache_block_size].pgnum == RMEM_NULL)
+			return (base + i*cache_block_size);
+	}
+
+	return (-ENOMEM);
+}
+
+/*============================================================================*
+ * nanvix_rcache_flagged_line()                                               *
+ *============================================================================*/
+
+/**
+ * @brief Searches for a flagged line in a set.
+ *
+ * @param set  Number of the target set.
+ * @param flag Target flag.
+ *
+ * @returns The index of the first slot of a line flagged with @p flag
+ * that may be evicted, or RMEM_CACHE_NULL if there is none.
+ */
+static int nanvix_rcache_flagged_line(int set, int flag)
+{
+	int idx;
+	int base;
+
+	base = set*cache_ways*cache_block_size;
+	for (int i = 0; i < cache_ways; i++)
+	{
+		idx = base + i*cache_block_size;
+
+		if (!(cache_slots[idx].flags & flag))
+			continue;
+
+		if (!nanvix_rcache_line_is_busy(idx) && !nanvix_rcache_line_is_pinned(idx))
+			return (idx);
+	}
+
+	return (RMEM_CACHE_NULL);
+}
+
+/*============================================================================*
+ * nanvix_rcache_fifo()                                                       *
+ *============================================================================*/
+
+/**
+ * @brief Evicts pages from the cache based on the FIFO replacement policy.
+ *
+ * @param set Number of the target set.
+ *
+ * @returns Upon successful completion, the index of the page is
+ * returned. Upon failure a negative error code is returned instead.
+ */
+static int nanvix_rcache_fifo(int set)
+{
+	int idx;
+	int age;
+	int min_age;
+	int base;
+
+	/* Cache has space. */
+	if ((idx = nanvix_rcache_free_line(set)) >= 0)
+		return (idx);
+
+	/*
+	 * No space. Make evict. Skip lines that are in use, and
+	 * prefer clean lines on ties.
+	 */
+	base = set*cache_ways*cache_block_size;
+	idx = RMEM_CACHE_NULL;
+	min_age = 0;
+	for (int i = base; i < base + cache_ways*cache_block_size; i += cache_block_size)
+	{
+		if (nanvix_rcache_line_is_busy(i) || nanvix_rcache_line_is_pinned(i))
+			continue;
+
+		age = cache_slots[i].age;
+		if ((idx == RMEM_CACHE_NULL) || (age < min_age) ||
+			((age == min_age) && nanvix_rcache_line_is_dirty(idx) && !nanvix_rcache_line_is_dirty(i)))
+		{
+		    idx = i;
+		    min_age = age;
+		}
+	}
+
+	/* Lines are being loaded or in use. */
+	if (idx == RMEM_CACHE_NULL)
+		return (-EAGAIN);
+
+	return (idx);
+}
+
+/*============================================================================*
+ * nanvix_rcache_lru()                                                        *
+ *============================================================================*/
+
+/**
+ * @brief Evicts pages from the cache based on the LRU replacement policy.
+ *
+ * The least recently used line sits at the tail of the recency list,
+ * thus a victim is found in constant time.
+ *
+ * @param set Number of the target set.
+ *
+ * @returns Upon successful completion, the index of the page is
+ * returned. Upon failure a negative error code is returned instead.
+ */
+static int nanvix_rcache_lru(int set)
+{
+	int idx;
+
+	/* Cache has space. */
+	if ((idx = nanvix_rcache_free_line(set)) >= 0)
+		return (idx);
+
+	/* No space. Make evict. Skip lines that are in use. */
+	if ((idx = nanvix_rcache_list_victim(&cache_sets[set].lru)) == RMEM_CACHE_NULL)
+		idx = nanvix_rcache_list_victim(&cache_sets[set].a1in);
+
+	/* Lines are being loaded or in use. */
+	if (idx == RMEM_CACHE_NULL)
+		return (-EAGAIN);
+
+	return (idx);
+}
+
+/*============================================================================*
+ * nanvix_rcache_aging()                                                      *
+ *============================================================================*/
+
+/**
+ * @brief Evicts pages from the cache based on the Aging replacement policy.
+ *
+ * Every access shifts the aging counters of the lines of the set and
+ * sets the top bit of the accessed line, thus the line with the
+ * smallest counter is the least used lately.
+ *
+ * @param set Number of the target set.
+ *
+ * @returns Upon successful completion, the index of the page is
+ * returned. Upon failure a negative error code is returned instead.
+ */
+static int nanvix_rcache_aging(int set)
+{
+	int idx;
+	uint32_t age;
+	uint32_t min_age;
+	int base;
+
+	/* Cache has space. */
+	if ((idx = nanvix_rcache_free_line(set)) >= 0)
+		return (idx);
+
+	/*
+	 * No space. Make evict. Skip lines that are in use, and
+	 * prefer clean lines on ties.
+	 */
+	base = set*cache_ways*cache_block_size;
+	idx = RMEM_CACHE_NULL;
+	min_age = 0;
+	for (int i = base; i < base + cache_ways*cache_block_size; i += cache_block_size)
+	{
+		if (nanvix_rcache_line_is_busy(i) || nanvix_rcache_line_is_pinned(i))
+			continue;
+
+		age = (uint32_t) cache_slots[i].age;
+		if ((idx == RMEM_CACHE_NULL) || (age < min_age) ||
+			((age == min_age) && nanvix_rcache_line_is_dirty(idx) && !nanvix_rcache_line_is_dirty(i)))
+		{
+		    idx = i;
+		    min_age = age;
+		}
+	}
+
+	/* Lines are being loaded or in use. */
+	if (idx == RMEM_CACHE_NULL)
+		return (-EAGAIN);
+
+	return (idx);
+}
+
+/*============================================================================*
+ * nanvix_rcache_lifo()                                                       *
+ *============================================================================*/
+
+/**
+ * @brief Evicts pages from the cache based on the LIFO replacement policy.
+ *
+ * @param set Number of the target set.
+ *
+ * @returns Upon successful completion, the index of the page is
+ * returned. Upon failure a negative error code is returned instead.
+ */
+static int nanvix_rcache_lifo(int set)
+{
+	int idx;
+	int age;
+	int max_age;
+	int base;
+
+	/* Cache has space. */
+	if ((idx = nanvix_rcache_free_line(set)) >= 0)
+		return (idx);
+
+	/*
+	 * No space. Make evict. Skip lines that are in use, and
+	 * prefer clean lines on ties.
+	 */
+	base = set*cache_ways*cache_block_size;
+	idx = RMEM_CACHE_NULL;
+	max_age = 0;
+	for (int i = base; i < base + cache_ways*cache_block_size; i += cache_block_size)
+	{
+		if (nanvix_rcache_line_is_busy(i) || nanvix_rcache_line_is_pinned(i))
+			continue;
+
+		age = cache_slots[i].age;
+		if ((idx == RMEM_CACHE_NULL) || (age > max_age) ||
+			((age == max_age) && nanvix_rcache_line_is_dirty(idx) && !nanvix_rcache_line_is_dirty(i)))
+		{
+		    idx = i;
+		    max_age = age;
+		}
+	}
+
+	/* Lines are being loaded or in use. */
+	if (idx == RMEM_CACHE_NULL)
+		return (-EAGAIN);
+
+	return (idx);
+}
+
+/*============================================================================*
+ * nanvix_rcache_clock()                                                      *
+ *============================================================================*/
+
+/**
+ * @brief Evicts pages from the cache based on the CLOCK replacement policy.
+ *
+ * The hand sweeps over cache lines, giving a second chance to lines
+ * that were referenced since the last sweep. Hits only set the
+ * reference bit, and the cost of a sweep is amortized over misses.
+ * Among unreferenced lines, a clean one found within a revolution is
+ * preferred, since evicting it costs no write-back.
+ *
+ * @param set Number of the target set.
+ *
+ * @returns Upon successful completion, the index of the page is
+ * returned. Upon failure a negative error code is returned instead.
+ */
+static int nanvix_rcache_clock(int set)
+{
+	int idx;
+	int way;
+	int base;
+
+	/* Cache has space. */
+	if ((idx = nanvix_rcache_free_line(set)) >= 0)
+		return (idx);
+
+	base = set*cache_ways*cache_block_size;
+
+	/* No space. Make evict. Skip lines that are in use. */
+	way = -1;
+	for (int i = 0, j = cache_sets[set].hand; i < cache_ways; i++)
+	{
+		idx = base + j*cache_block_size;
+
+		/* Found an unreferenced clean line. */
+		if (!nanvix_rcache_line_is_busy(idx) && !(cache_slots[idx].flags & RMEM_CACHE_SLOT_REF) &&
+			!nanvix_rcache_line_is_dirty(idx) && !nanvix_rcache_line_is_pinned(idx))
+		{
+			way = j;
+			break;
+		}
+
+		if (++j == cache_ways)
+			j = 0;
+	}
+
+	/* Fallback to second chance. */
+	for (int i = 0, j = cache_sets[set].hand; (way < 0) && (i < 2*cache_ways); i++)
+	{
+		idx = base + j*cache_block_size;
+
+		if (!nanvix_rcache_line_is_busy(idx) && !nanvix_rcache_line_is_pinned(idx))
+		{
+			if (!(cache_slots[idx].flags & RMEM_CACHE_SLOT_REF))
+				way = j;
+			cache_slots[idx].flags &= ~RMEM_CACHE_SLOT_REF;
+		}
+
+		if (++j == cache_ways)
+			j = 0;
+	}
+
+	/* Lines are being loaded or in use. */
+	if (way < 0)
+		return (-EAGAIN);
+
+	idx = base + way*cache_block_size;
+	cache_sets[set].hand = (way + 1 == cache_ways) ? 0 : (way + 1);
+
+	return (idx);
+}
+
+/*============================================================================*
+ * nanvix_rcache_2q()                                                         *
+ *============================================================================*/
+
+/**
+ * @brief Evicts pages from the cache based on the 2Q replacement policy.
+ *
+ * Lines referenced for the first time enter the A1in FIFO queue, and
+ * only lines whose pages are referenced again after leaving it are
+ * admitted into the main LRU list. Long sequential sweeps are thus
+ * confined to A1in.
+ *
+ * @param set Number of the target set.
+ *
+ * @returns Upon successful completion, the index of the page is
+ * returned. Upon failure a negative error code is returned instead.
+ */
+static int nanvix_rcache_2q(int set)
+{
+	int idx;
+	struct cache_list *first;
+	struct cache_list *second;
+
+	/* Cache has space. */
+	if ((idx = nanvix_rcache_free_line(set)) >= 0)
+		return (idx);
+
+	/* No space. Make evict. Skip lines that are in use. */
+	first = &cache_sets[set].lru;
+	second = &cache_sets[set].a1in;
+	if ((cache_sets[set].a1in.length > RMEM_CACHE_2Q_KIN) || (cache_sets[set].lru.tail == RMEM_CACHE_NULL))
+	{
+		first = &cache_sets[set].a1in;
+		second = &cache_sets[set].lru;
+	}
+	if ((idx = nanvix_rcache_list_victim(first)) == RMEM_CACHE_NULL)
+		idx = nanvix_rcache_list_victim(second);
+
+	/* Lines are being loaded or in use. */
+	if (idx == RMEM_CACHE_NULL)
+		return (-EAGAIN);
+
+	return (idx);
+}
+
+/*============================================================================*
+ * nanvix_rcache_duel_leader()                                                *
+ *============================================================================*/
+
+/**
+ * @brief Gets the candidate policy that leads a set.
+ *
+ * @param set Number of the target set.
+ *
+ * @returns If @p set is a leader set, the index of its candidate policy
+ * is returned. Otherwise, RMEM_CACHE_NULL is returned instead.
+ */
+static int nanvix_rcache_duel_leader(int set)
+{
+	/* Too few sets. */
+	if ((cache_length/cache_ways) < RMEM_CACHE_DUEL_PERIOD)
+		return (RMEM_CACHE_NULL);
+
+	return (((set%RMEM_CACHE_DUEL_PERIOD) < RMEM_CACHE_DUEL_NCANDIDATES) ?
+		(set%RMEM_CACHE_DUEL_PERIOD) : RMEM_CACHE_NULL);
+}
+
+/*============================================================================*
+ * nanvix_rcache_duel_record()                                                *
+ *============================================================================*/
+
+/**
+ * @brief Counts an access to a set in the duel.
+ *
+ * The caller should hold the statistics lock.
+ *
+ * @param set  Number of the accessed set.
+ * @param miss Was the access a miss?
+ */
+static void nanvix_rcache_duel_record(int set, int miss)
+{
+	int c;
+	int w;
+
+	/* Nothing to do. */
+	if ((cache_policy != RMEM_CACHE_ADAPTIVE) || ((c = nanvix_rcache_duel_leader(set)) == RMEM_CACHE_NULL))
+		return;
+
+	cache_duel.naccesses[c]++;
+	if (miss)
+		cache_duel.nmisses[c]++;
+
+	/* Lowest miss ratio wins. */
+	w = cache_duel.winner;
+	for (int i = 0; i < RMEM_CACHE_DUEL_NCANDIDATES; i++)
+	{
+		if (cache_duel.naccesses[i] == 0)
+			continue;
+
+		if ((cache_duel.naccesses[w] == 0) ||
+			(((unsigned long long)cache_duel.nmisses[i])*cache_duel.naccesses[w] <
+			 ((unsigned long long)cache_duel.nmisses[w])*cache_duel.naccesses[i]))
+			w = i;
+	}
+	cache_duel.winner = w;
+
+	/* Age counts. */
+	if (++cache_duel.nepoch == RMEM_CACHE_DUEL_EPOCH)
+	{
+		for (int i = 0; i < RMEM_CACHE_DUEL_NCANDIDATES; i++)
+		{
+			cache_duel.naccesses[i] >>= 1;
+			cache_duel.nmisses[i] >>= 1;
+		}
+		cache_duel.nepoch = 0;
+	}
+}
+
+/*============================================================================*
+ * nanvix_rcache_set_policy()                                                 *
+ *============================================================================*/
+
+/**
+ * @brief Gets the replacement policy of a set.
+ *
+ * @param set Number of the target set.
+ *
+ * @returns The number of the replacement policy that runs in @p set.
+ */
+static int nanvix_rcache_set_policy(int set)
+{
+	int c;
+
+	/* Nothing to do. */
+	if (cache_policy != RMEM_CACHE_ADAPTIVE)
+		return (cache_policy);
+
+	if ((c = nanvix_rcache_duel_leader(set)) == RMEM_CACHE_NULL)
+	{
+		nanvix_mutex_lock(&stats_lock);
+			c = cache_duel.winner;
+		nanvix_mutex_unlock(&stats_lock);
+	}
+
+	return (cache_duel_candidates[c]);
+}
+
+/*============================================================================*
+ * nanvix_rcache_replacement_policies()                                       *
+ *============================================================================*/
+
+/**
+ * @brief Selects the replacement policy function based on the
+ * replacement policy number.
+ *
+ * The line picked by the policy is left untouched, so that the caller
+ * may still give up on it. If the admission filter refuses the
+ * incoming page, it replaces a line that was refused before instead,
+ * if there is any.
+ *
+ * @param set       Number of the target set.
+ * @param pgnum     Number of the incoming page, or RMEM_NULL if it
+ * should not go through the admission filter.
+ * @param probation Store location for whether the incoming page was
+ * refused by the admission filter.
+ *
+ * @returns Upon successful completion, the free index of a page is
+ * returned. Upon failure a negative error code is returned instead.
+ */
+static int nanvix_rcache_replacement_policies(int set, rpage_t pgnum, int *probation)
+{
+	int idx;
+	int line;
+	int policy;
+	int refused;
+
+	*probation = 0;
+
+	/* Lines released by the application go first. */
+	if ((nanvix_rcache_free_line(set) < 0) && ((idx = nanvix_rcache_flagged_line(set, RMEM_CACHE_SLOT_RELEASED)) != RMEM_CACHE_NULL))
+		return (idx);
+
+	policy = nanvix_rcache_set_policy(set);
+
+	if (policy == RMEM_CACHE_FIFO)
+		idx = nanvix_rcache_fifo(set);
+	else if (policy == RMEM_CACHE_LIFO)
+		idx = nanvix_rcache_lifo(set);
+	else if (policy == RMEM_CACHE_CLOCK)
+		idx = nanvix_rcache_clock(set);
+	else if (policy == RMEM_CACHE_2Q)
+		idx = nanvix_rcache_2q(set);
+	else if (policy == RMEM_CACHE_AGING)
+		idx = nanvix_rcache_aging(set);
+	else
+		idx = nanvix_rcache_lru(set);
+
+	if (idx < 0)
+		return (idx);
+
+	/* Page is not worth the line. */
+	if ((pgnum != RMEM_NULL) && nanvix_rcache_line_is_valid(idx))
+	{
+		nanvix_mutex_lock(&stats_lock);
+			refused = !nanvix_rcache_filter_admit(pgnum, cache_slots[idx].pgnum);
+			if (refused)
+				stats.nrejections++;
+		nanvix_mutex_unlock(&stats_lock);
+
+		if (refused)
+		{
+			*probation = 1;
+			if ((line = nanvix_rcache_flagged_line(set, RMEM_CACHE_SLOT_PROBATION)) != RMEM_CACHE_NULL)
+				idx = line;
+		}
+	}
+
+	return (idx);
+}
+
+/*============================================================================*
+ * nanvix_rcache_line_evict()                                                 *
+ *============================================================================*/
+
+/**
+ * @brief Evicts the pages of a cache line.
+ *
+ * Modified pages are written back, and pages evicted from A1in are
+ * remembered by 2Q. The line itself is dropped by the caller.
+ *
+ * @param idx Index of the first slot of the target line.
+ *
+ * @returns Upon successful completion, zero is returned. Upon
+ * failure a negative error code is returned instead.
+ */
+static int nanvix_rcache_line_evict(int idx)
+{
+	/* Line is free. */
+	if (!nanvix_rcache_line_is_valid(idx))
+		return (0);
+
+	/* Remember pages evicted from A1in. */
+	if ((cache_policy == RMEM_CACHE_2Q) && (cache_slots[idx].flags & RMEM_CACHE_SLOT_A1IN))
+	{
+		nanvix_mutex_lock(&cache_lock);
+			nanvix_rcache_ghost_insert(cache_slots[idx].pgnum);
+		nanvix_mutex_unlock(&cache_lock);
+	}
+
+	return ((nanvix_rcache_line_writeback(idx) < 0) ? -EFAULT : 0);
+}
+
+/*============================================================================*
+ * nanvix_rcache_mshr_alloc()                                                 *
+ *============================================================================*/
+
+/**
+ * @brief Tracks a miss.
+ *
+ * The caller should hold the cache lock.
+ *
+ * @param line Index of the first slot of the line being loaded.
+ *
+ * @returns Upon successful completion, the number of the register is
+ * returned. If all registers are in use, a negative error code is
+ * returned instead.
+ */
+static int nanvix_rcache_mshr_alloc(int line)
+{
+	for (int i = 0; i < RMEM_CACHE_MSHR_LENGTH; i++)
+	{
+		/* Found. */
+		if (cache_mshr.entries[i].line == RMEM_CACHE_NULL)
+		{
+			cache_mshr.entries[i].line = line;
+			cache_mshr.entries[i].nwaiters = 0;
+			cache_mshr.length++;
+			return (i);
+		}
+	}
+
+	return (-EAGAIN);
+}
+
+/*============================================================================*
+ * nanvix_rcache_mshr_search()                                                *
+ *============================================================================*/
+
+/**
+ * @brief Searches for the register that tracks a miss.
+ *
+ * The caller should hold the cache lock.
+ *
+ * @param line Index of the first slot of the line being loaded.
+ *
+ * @returns The number of the register that tracks the line.
+ */
+static int nanvix_rcache_mshr_search(int line)
+{
+	for (int i = 0; i < RMEM_CACHE_MSHR_LENGTH; i++)
+	{
+		/* Found. */
+		if (cache_mshr.entries[i].line == line)
+			return (i);
+	}
+
+	uassert(0);
+
+	return (-EFAULT);
+}
+
+/*============================================================================*
+ * nanvix_rcache_mshr_free()                                                  *
+ *============================================================================*/
+
+/**
+ * @brief Completes a miss.
+ *
+ * The caller should hold the cache lock. Waiting threads are woken
+ * up, and they look the page up again.
+ *
+ * @param mshr Number of the target register.
+ */
+static void nanvix_rcache_mshr_free(int mshr)
+{
+	for (int i = 0; i < cache_mshr.entries[mshr].nwaiters; i++)
+		uassert(nanvix_semaphore_up(&cache_mshr.entries[mshr].done) == 0);
+
+	cache_mshr.entries[mshr].line = RMEM_CACHE_NULL;
+	cache_mshr.entries[mshr].nwaiters = 0;
+	cache_mshr.length--;
+}
+
+/*============================================================================*
+ * nanvix_rcache_page_lock()                                                  *
+ *============================================================================*/
+
+/**
+ * @brief Locks the line that holds a page.
+ *
+ * The page is looked up with the cache lock held, and then the lock
+ * of its set is taken. If the page was evicted or the geometry of the
+ * cache changed meanwhile, the lookup is retried. If the page is
+ * being loaded, the caller waits for the outstanding miss.
+ *
+ * @param pgnum Number of the target page.
+ *
+ * @returns If the page is cached, the index of its slot is returned
+ * and the lock of its set is held. Otherwise, a negative error code
+ * is returned instead.
+ */
+static int nanvix_rcache_page_lock(rpage_t pgnum)
+{
+	int idx;
+	int mshr;
+	struct cache_set *set = NULL;
+
+	while (1)
+	{
+		nanvix_mutex_lock(&cache_lock);
+			if ((idx = nanvix_rcache_page_search(pgnum)) >= 0)
+				set = nanvix_rcache_line_set(idx);
+		nanvix_mutex_unlock(&cache_lock);
+
+		/* Page is not cached. */
+		if (idx < 0)
+			return (-EFAULT);
+
+		nanvix_mutex_lock(&set->lock);
+
+			/* Page is still there. */
+			if ((nanvix_rcache_line_set(idx) == set) && (cache_slots[idx].pgnum == pgnum))
+			{
+				if (!nanvix_rcache_line_is_busy(idx - (idx%cache_block_size)))
+					return (idx);
+
+				/* Page is being loaded. */
+				nanvix_mutex_lock(&cache_lock);
+					mshr = nanvix_rcache_mshr_search(idx - (idx%cache_block_size));
+					cache_mshr.entries[mshr].nwaiters++;
+				nanvix_mutex_unlock(&cache_lock);
+
+				nanvix_mutex_unlock(&set->lock);
+
+				uassert(nanvix_semaphore_down(&cache_mshr.entries[mshr].done) == 0);
+
+				continue;
+			}
+
+		nanvix_mutex_unlock(&set->lock);
+	}
+}
+
+/*============================================================================*
+ * nanvix_rcache_set_lock()                                                   *
+ *============================================================================*/
+
+/**
+ * @brief Locks the set in which a page should be loaded.
+ *
+ * @param pgnum Number of the target page.
+ *
+ * @returns If the page is not cached, the number of its set is
+ * returned and the lock of the set is held. Otherwise, -EEXIST is
+ * returned instead.
+ */
+static int nanvix_rcache_set_lock(rpage_t pgnum)
+{
+	int set;
+	int moved;
+	int cached;
+
+	while (1)
+	{
+		nanvix_mutex_lock(&cache_lock);
+			set = nanvix_rcache_page_set(pgnum);
+		nanvix_mutex_unlock(&cache_lock);
+
+		nanvix_mutex_lock(&cache_sets[set].lock);
+
+			nanvix_mutex_lock(&cache_lock);
+				cached = (nanvix_rcache_page_search(pgnum) >= 0);
+				moved = (nanvix_rcache_page_set(pgnum) != set);
+			nanvix_mutex_unlock(&cache_lock);
+
+			/* Page was loaded by another thread. */
+			if (!cached && !moved)
+				return (set);
+
+		nanvix_mutex_unlock(&cache_sets[set].lock);
+
+		if (cached)
+			return (-EEXIST);
+	}
+}
+
+/*============================================================================*
+ * nanvix_rcache_select_replacement_policy()                                  *
+ *============================================================================*/
+
+/**
+ * @todo TODO: provide a detailed description for this function.
+ */
+int nanvix_rcache_select_replacement_policy(int num)
+{
+	switch (num)
+	{
+		case RMEM_CACHE_FIFO:
+		case RMEM_CACHE_LIFO:
+		case RMEM_CACHE_LRU:
+		case RMEM_CACHE_AGING:
+		case RMEM_CACHE_CLOCK:
+		case RMEM_CACHE_2Q:
+		case RMEM_CACHE_ADAPTIVE:
+			break;
+		default:
+			return (-EFAULT);
+	}
+
+	nanvix_rcache_lock_all();
+
+		/* Aging counters and load times do not mix. */
+		if ((num == RMEM_CACHE_AGING) != (cache_policy == RMEM_CACHE_AGING))
+		{
+			for (int i = 0; i < RMEM_CACHE_FRAMES; i++)
+				cache_slots[i].age = 0;
+		}
+
+		cache_policy = num;
+
+		/* Start a new duel. */
+		nanvix_mutex_lock(&stats_lock);
+			for (int i = 0; i < RMEM_CACHE_DUEL_NCANDIDATES; i++)
+			{
+				cache_duel.naccesses[i] = 0;
+				cache_duel.nmisses[i] = 0;
+			}
+			cache_duel.nepoch = 0;
+			cache_duel.winner = 0;
+		nanvix_mutex_unlock(&stats_lock);
+
+		/* Hand A1in lines over to the LRU list, as least recently used. */
+		if (cache_policy != RMEM_CACHE_2Q)
+		{
+			for (int i = 0; i < cache_length/cache_ways; i++)
+			{
+				struct cache_set *set = &cache_sets[i];
+
+				while (set->a1in.head != RMEM_CACHE_NULL)
+				{
+					int idx = set->a1in.head;
+
+					nanvix_rcache_list_remove(&set->a1in, idx);
+					cache_slots[idx].flags &= ~RMEM_CACHE_SLOT_A1IN;
+
+					if (set->lru.tail != RMEM_CACHE_NULL)
+					{
+						cache_slots[set->lru.tail].lnext = idx;
+						cache_slots[idx].lprev = set->lru.tail;
+					}
+					else
+						set->lru.head = idx;
+					set->lru.tail = idx;
+					set->lru.length++;
+				}
+			}
+		}
+
+	nanvix_rcache_unlock_all();
+
+	return (0);
+}
+
+/*============================================================================*
+ * nanvix_rcache_select_associativity()                                       *
+ *============================================================================*/
+
+/**
+ * @brief Selects the associativity of the cache.
+ *
+ * Pages are mapped to sets of @p ways lines, so that lookups and
+ * victim selection are bounded by the associativity rather than by
+ * the length of the cache. Changing the associativity writes back all
+ * modified pages and empties the cache, thus it fails while any page
+ * is held.
+ */
+int nanvix_rcache_select_associativity(int ways)
+{
+	int ret = 0;
+
+	nanvix_rcache_lock_all();
+
+		/* Invalid associativity. */
+		if ((ways <= 0) || (ways > cache_length) || ((cache_length % ways) != 0))
+			ret = -EINVAL;
+
+		/* Lines are in use. */
+		else if (nanvix_rcache_is_pinned())
+			ret = -EBUSY;
+
+		/* Write back modified pages. */
+		else if (nanvix_rcache_writeback_all() < 0)
+			ret = -EFAULT;
+
+		else
+		{
+			nanvix_rcache_reset();
+			cache_ways = ways;
+		}
+
+	nanvix_rcache_unlock_all();
+
+	return (ret);
+}
+
+/*============================================================================*
+ * nanvix_rcache_init()                                                       *
+ *============================================================================*/
+
+/**
+ * @brief Sets the geometry of the cache.
+ *
+ * Frames are taken from a pool of RMEM_CACHE_FRAMES pages. Modified
+ * pages are written back, and the cache is left empty and fully
+ * associative. Nothing changes while any page is held.
+ */
+int nanvix_rcache_init(int nlines, int block_size)
+{
+	int ret = 0;
+
+	/* Invalid line size. */
+	if ((block_size <= 0) || (block_size >= RMEM_NUM_BLOCKS))
+		return (-EINVAL);
+
+	/* Invalid length. */
+	if ((nlines <= 0) || (nlines > RMEM_CACHE_FRAMES/block_size))
+		return (-EINVAL);
+
+	nanvix_rcache_lock_all();
+
+		/* Lines are in use. */
+		if (nanvix_rcache_is_pinned())
+			ret = -EBUSY;
+
+		/* Write back modified pages. */
+		else if (nanvix_rcache_writeback_all() < 0)
+			ret = -EFAULT;
+
+		else
+		{
+			nanvix_rcache_reset();
+			cache_length = nlines;
+			cache_block_size = block_size;
+			cache_ways = nlines;
+		}
+
+	nanvix_rcache_unlock_all();
+
+	return (ret);
+}
+
+/*============================================================================*
+ * nanvix_rcache_resize()                                                     *
+ *============================================================================*/
+
+/**
+ * @brief Changes the length of the cache.
+ *
+ * A fully associative cache keeps its contents: growing adds free
+ * lines, and shrinking evicts the lines that no longer fit, unless
+ * any of them is in use. A set-associative cache maps pages to sets
+ * by their number, so it is written back and emptied instead, unless
+ * any page is held. It keeps its associativity if that still divides
+ * the new length, and becomes fully associative otherwise.
+ */
+int nanvix_rcache_resize(int nlines)
+{
+	int ret = 0;
+
+	nanvix_rcache_lock_all();
+
+		/* Invalid length. */
+		if ((nlines <= 0) || (nlines > RMEM_CACHE_FRAMES/cache_block_size))
+			ret = -EINVAL;
+
+		/* Set-associative cache. */
+		else if (cache_ways != cache_length)
+		{
+			/* Lines are in use. */
+			if (nanvix_rcache_is_pinned())
+				ret = -EBUSY;
+			else if (nanvix_rcache_writeback_all() < 0)
+				ret = -EFAULT;
+			else
+			{
+				nanvix_rcache_reset();
+				cache_length = nlines;
+				if ((cache_ways > nlines) || ((nlines % cache_ways) != 0))
+					cache_ways = nlines;
+			}
+		}
+
+		else
+		{
+			/* Lines that do not fit are in use. */
+			for (int i = nlines*cache_block_size; i < cache_length*cache_block_size; i += cache_block_size)
+			{
+				if (nanvix_rcache_line_is_pinned(i))
+				{
+					ret = -EBUSY;
+					break;
+				}
+			}
+
+			/* Evict lines that do not fit. */
+			for (int i = nlines*cache_block_size; (ret == 0) && (i < cache_length*cache_block_size); i += cache_block_size)
+			{
+				if (nanvix_rcache_line_writeback(i) < 0)
+				{
+					ret = -EFAULT;
+					break;
+				}
+
+				if (nanvix_rcache_line_is_valid(i))
+				{
+					nanvix_mutex_lock(&stats_lock);
+						stats.nevictions++;
+					nanvix_mutex_unlock(&stats_lock);
+				}
+				nanvix_rcache_line_invalidate(i);
+			}
+
+			if (ret == 0)
+			{
+				cache_length = nlines;
+				cache_ways = nlines;
+				if (cache_sets[0].hand >= nlines)
+					cache_sets[0].hand = 0;
+			}
+		}
+
+	nanvix_rcache_unlock_all();
+
+	return (ret);
+}
+
+/*============================================================================*
+ * nanvix_rcache_select_prefetch()                                            *
+ *============================================================================*/
+
+/**
+ * @brief Turns the stride prefetcher on or off.
+ */
+int nanvix_rcache_select_prefetch(int enable)
+{
+	nanvix_rcache_lock_all();
+		cache_prefetch = (enable != 0);
+	nanvix_rcache_unlock_all();
+
+	return (0);
+}
+
+/*============================================================================*
+ * nanvix_rcache_select_victim()                                              *
+ *============================================================================*/
+
+/**
+ * @brief Turns the victim tier on or off.
+ *
+ * Turning the tier off drops the pages that it holds.
+ */
+int nanvix_rcache_select_victim(int enable)
+{
+	nanvix_mutex_lock(&cache_victim.lock);
+
+		cache_victim.enabled = (enable != 0);
+
+		if (!cache_victim.enabled)
+			nanvix_rcache_victim_flush();
+
+	nanvix_mutex_unlock(&cache_victim.lock);
+
+	return (0);
+}
+
+/*============================================================================*
+ * nanvix_rcache_select_filter()                                              *
+ *============================================================================*/
+
+/**
+ * @brief Turns the admission filter on or off.
+ *
+ * The filter starts over with a blank sketch.
+ */
+int nanvix_rcache_select_filter(int enable)
+{
+	nanvix_mutex_lock(&stats_lock);
+
+		cache_filter.enabled = (enable != 0);
+		cache_filter.naccesses = 0;
+		for (int i = 0; i < RMEM_CACHE_FILTER_DEPTH; i++)
+		{
+			for (int j = 0; j < RMEM_CACHE_FILTER_WIDTH; j++)
+				cache_filter.counts[i][j] = 0;
+		}
+
+	nanvix_mutex_unlock(&stats_lock);
+
+	return (0);
+}
+
+/*============================================================================*
+ * nanvix_rcache_stats_sample()                                               *
+ *============================================================================*/
+
+/**
+ * @brief Samples an access to a page.
+ *
+ * Each access is counted in the histogram with probability
+ * 1/RMEM_CACHE_HEAT_PERIOD, drawn from a xorshift generator, so that
+ * it shows hot pages at a small cost. Counting every n-th access
+ * instead would miss or overcount pages that recur with a period that
+ * shares a factor with n. The caller should hold the statistics lock.
+ *
+ * @param pgnum Number of the accessed page.
+ */
+static void nanvix_rcache_stats_sample(rpage_t pgnum)
+{
+	stats.seed ^= stats.seed << 13;
+	stats.seed ^= stats.seed >> 17;
+	stats.seed ^= stats.seed << 5;
+
+	if ((stats.seed % RMEM_CACHE_HEAT_PERIOD) == 0)
+		stats.heat[RMEM_BLOCK_SERVER(pgnum)][RMEM_BLOCK_NUM(pgnum)]++;
+}
+
+/*============================================================================*
+ * nanvix_rcache_mrc_access()                                                 *
+ *============================================================================*/
+
+/**
+ * @brief Feeds an access to the miss ratio curve.
+ *
+ * The caller should hold the statistics lock.
+ *
+ * @param pgnum Number of the accessed page.
+ */
+static void nanvix_rcache_mrc_access(rpage_t pgnum)
+{
+	int pos;
+
+	/* Page is not sampled. */
+	if (!RMEM_CACHE_MRC_SAMPLED(pgnum))
+		return;
+
+	cache_mrc.naccesses++;
+
+	for (pos = 0; pos < cache_mrc.length; pos++)
+	{
+		/* Found. */
+		if (cache_mrc.stack[pos] == pgnum)
+			break;
+	}
+
+	/* Reuse. */
+	if (pos < cache_mrc.length)
+		cache_mrc.hist[pos]++;
+
+	/* First access, or too far apart. */
+	else if (cache_mrc.length < RMEM_CACHE_MRC_DEPTH)
+		pos = cache_mrc.length++;
+	else
+		pos = RMEM_CACHE_MRC_DEPTH - 1;
+
+	/* Move page to the top of the stack. */
+	for (int i = pos; i > 0; i--)
+		cache_mrc.stack[i] = cache_mrc.stack[i - 1];
+	cache_mrc.stack[0] = pgnum;
+}
+
+/*============================================================================*
+ * nanvix_rcache_miss_ratio()                                                 *
+ *============================================================================*/
+
+/**
+ * @brief Estimates the miss ratio of the cache for some size.
+ *
+ * The estimate is that of an LRU cache of @p npages pages, for the
+ * accesses seen so far.
+ */
+int nanvix_rcache_miss_ratio(int npages)
+{
+	int ret;
+	unsigned nhits = 0;
+
+	/* Invalid size. */
+	if ((npages <= 0) || (npages > RMEM_CACHE_FRAMES))
+		return (-EINVAL);
+
+	nanvix_mutex_lock(&stats_lock);
+
+		/* No samples yet. */
+		if (cache_mrc.naccesses == 0)
+			ret = -EAGAIN;
+
+		else
+		{
+			for (int pos = 0; (pos < RMEM_CACHE_MRC_DEPTH) && (pos*RMEM_CACHE_MRC_PERIOD < npages); pos++)
+				nhits += cache_mrc.hist[pos];
+
+			ret = (int)(((cache_mrc.naccesses - nhits)*1000ULL)/cache_mrc.naccesses);
+		}
+
+	nanvix_mutex_unlock(&stats_lock);
+
+	return (ret);
+}
+
+/*============================================================================*
+ * nanvix_rcache_autosize()                                                   *
+ *============================================================================*/
+
+/**
+ * @brief Resizes the cache after its miss ratio curve.
+ *
+ * The cache gets the fewest lines whose estimated miss ratio meets
+ * the target, or all frames if none does.
+ */
+int nanvix_rcache_autosize(int target)
+{
+	int ret;
+	int nlines;
+	int ratio;
+	int block_size;
+
+	/* Invalid target. */
+	if ((target < 0) || (target > 1000))
+		return (-EINVAL);
+
+	nanvix_mutex_lock(&cache_lock);
+		block_size = cache_block_size;
+	nanvix_mutex_unlock(&cache_lock);
+
+	for (nlines = 1; nlines < RMEM_CACHE_FRAMES/block_size; nlines++)
+	{
+		if ((ratio = nanvix_rcache_miss_ratio(nlines*block_size)) < 0)
+			return (ratio);
+
+		/* Found. */
+		if (ratio <= target)
+			break;
+	}
+
+	if ((ret = nanvix_rcache_resize(nlines)) < 0)
+		return (ret);
+
+	return (nlines);
+}
+
+/*============================================================================*
+ * nanvix_rcache_stats()                                                      *
+ *============================================================================*/
+
+/**
+ * @brief Reports the statistics of the cache.
+ *
+ * Counters are read at once, so they are consistent with each other.
+ * Pages queued for write-behind are accounted as written.
+ */
+int nanvix_rcache_stats(struct nanvix_rcache_stats *buf)
+{
+	/* Invalid buffer. */
+	if (buf == NULL)
+		return (-EINVAL);
+
+	nanvix_mutex_lock(&stats_lock);
+
+		buf->nhits = stats.nhits;
+		buf->nmisses = stats.nmisses;
+		buf->nevictions = stats.nevictions;
+		buf->nwritebacks = stats.nwritebacks;
+		buf->nprefetch_hits = stats.nprefetch_hits;
+		buf->nvictim_hits = stats.nvictim_hits;
+		buf->nrejections = stats.nrejections;
+		buf->nread = stats.nread;
+		buf->nwritten = stats.nwritten;
+
+		for (int i = 0; i < RMEM_SERVERS_NUM; i++)
+		{
+			for (int j = 0; j < RMEM_NUM_BLOCKS; j++)
+				buf->heat[i][j] = stats.heat[i][j];
+		}
+
+	nanvix_mutex_unlock(&stats_lock);
+
+	return (0);
+}
+
+/*============================================================================*
+ * nanvix_rcache_prefetch_stats()                                             *
+ *============================================================================*/
+
+/**
+ * @brief Reports the counters of the stride prefetcher.
+ */
+int nanvix_rcache_prefetch_stats(struct nanvix_rcache_prefetch_stats *buf)
+{
+	/* Invalid buffer. */
+	if (buf == NULL)
+		return (-EINVAL);
+
+	nanvix_mutex_lock(&stats_lock);
+		buf->nprefetches = stats.nprefetches;
+		buf->nuseful = stats.nprefetch_hits;
+		buf->nmisses = stats.nmisses;
+	nanvix_mutex_unlock(&stats_lock);
+
+	return (0);
+}
+
+/*============================================================================*
+ * nanvix_rcache_select_write()                                               *
+ *============================================================================*/
+
+/**
+ * @todo TODO: provide a detailed description for this function.
+ */
+int nanvix_rcache_select_write(int num)
+{
+	switch (num)
+	{
+		case RMEM_CACHE_WRITE_THROUGH:
+		case RMEM_CACHE_WRITE_BACK:
+			break;
+		default:
+			return (-EFAULT);
+	}
+
+	nanvix_rcache_lock_all();
+		write_num = num;
+	nanvix_rcache_unlock_all();
+
+	return (0);
+}
+
+/*============================================================================*
+ * nanvix_rcache_ralloc()                                                     *
+ *============================================================================*/
 
 /**
- * @brief Page cache.
+ * @todo TODO: provide a detailed description for this function.
  */
-typedef struct
+rpage_t nanvix_rcache_alloc(void)
 {
 	rpage_t pgnum;
-	char pages[RMEM_BLOCK_SIZE] ALIGN(PAGE_SIZE);
-#ifdef __RMEM_CACHE_AGING
-	uint32_t age;
-#else
-	int age;
+
+	/* Forward allocation to remote memory. */
+	if ((pgnum = nanvix_rmem_alloc()) == (rpage_t) -ENOMEM)
+		return (RMEM_NULL);
+
+	nanvix_mutex_lock(&cache_lock);
+		bitmap_set(cache_pages[RMEM_BLOCK_SERVER(pgnum)], RMEM_BLOCK_NUM(pgnum));
+	nanvix_mutex_unlock(&cache_lock);
+
+	/* Blocks are zeroed by remote memory. */
+	nanvix_mutex_lock(&cache_zero.lock);
+		bitmap_set(cache_zero.pages[RMEM_BLOCK_SERVER(pgnum)], RMEM_BLOCK_NUM(pgnum));
+	nanvix_mutex_unlock(&cache_zero.lock);
+
+	nanvix_mutex_lock(&stats_lock);
+		stats.nallocs++;
+	nanvix_mutex_unlock(&stats_lock);
+
+	return (pgnum);
+}
+
+/*============================================================================*
+ * nanvix_rcache_alloc_n()                                                    *
+ *============================================================================*/
+
+/**
+ * @brief Allocates many remote pages at once.
+ *
+ * Pages are requested in batches, thus the cost of a round trip to
+ * remote memory is paid once per batch rather than once per page.
+ */
+int nanvix_rcache_alloc_n(rpage_t *pgnums, int n)
+{
+	int err;
+
+	/* Forward allocation to remote memory. */
+	if ((err = nanvix_rmem_alloc_n(pgnums, n)) < 0)
+		return (err);
+
+	nanvix_mutex_lock(&cache_lock);
+		for (int i = 0; i < n; i++)
+			bitmap_set(cache_pages[RMEM_BLOCK_SERVER(pgnums[i])], RMEM_BLOCK_NUM(pgnums[i]));
+	nanvix_mutex_unlock(&cache_lock);
+
+	/* Blocks are zeroed by remote memory. */
+	nanvix_mutex_lock(&cache_zero.lock);
+		for (int i = 0; i < n; i++)
+			bitmap_set(cache_zero.pages[RMEM_BLOCK_SERVER(pgnums[i])], RMEM_BLOCK_NUM(pgnums[i]));
+	nanvix_mutex_unlock(&cache_zero.lock);
+
+	nanvix_mutex_lock(&stats_lock);
+		stats.nallocs += n;
+	nanvix_mutex_unlock(&stats_lock);
+
+	return (0);
+}
+
+/*============================================================================*
+ * nanvix_rcache_line_flush()                                                 *
+ *============================================================================*/
+
+/**
+ * @brief Writes all pages of a cache line back to remote memory.
+ *
+ * The caller should hold the lock of the set of the line.
+ *
+ * @param pgnum Number of a page of the line.
+ * @param idx   Index of the slot of @p pgnum.
+ *
+ * @returns Upon successful completion, zero is returned. Upon
+ * failure a negative error code is returned instead.
+ */
+static int nanvix_rcache_line_flush(rpage_t pgnum, int idx)
+{
+	int pgnum_block;
+	int pgnum_abs;
+	int idx_abs;
+
+	pgnum_block = idx%cache_block_size;
+	pgnum_abs = (int)(pgnum - pgnum_block);
+	idx_abs = idx - pgnum_block;
+	/* Write page back to remote memory. */
+	for (int i = 0; i < cache_block_size; i++)
+	{
+		/* Page is not in this line. */
+		if (cache_slots[idx_abs+i].pgnum != (rpage_t)(pgnum_abs+i))
+			continue;
+
+		nanvix_rcache_zero_clear((rpage_t)(pgnum_abs+i));
+
+		if (nanvix_rmem_write((rpage_t)(pgnum_abs+i), cache_frames[idx_abs+i]) != RMEM_BLOCK_SIZE)
+			return (-EFAULT);
+		cache_slots[idx_abs+i].flags &= ~RMEM_CACHE_SLOT_DIRTY;
+		nanvix_rcache_victim_remove((rpage_t)(pgnum_abs+i));
+
+		nanvix_mutex_lock(&stats_lock);
+			stats.nwritten += RMEM_BLOCK_SIZE;
+		nanvix_mutex_unlock(&stats_lock);
+	}
+
+	return (0);
+}
+
+/*============================================================================*
+ * nanvix_rcache_flush()                                                      *
+ *============================================================================*/
+
+/**
+ * @todo TODO: provide a detailed description for this function.
+ */
+int nanvix_rcache_flush(rpage_t pgnum)
+{
+	int err;
+	int idx;
+	struct cache_set *set;
+
+	/* Invalid page number. */
+	if ((pgnum == RMEM_NULL) || (RMEM_BLOCK_NUM(pgnum) >= RMEM_NUM_BLOCKS))
+		return (-EFAULT);
+
+	/* Search for page in the cache. */
+	if ((idx = nanvix_rcache_page_lock(pgnum)) < 0)
+		return (-EFAULT);
+
+	set = nanvix_rcache_line_set(idx);
+	err = nanvix_rcache_line_flush(pgnum, idx);
+	nanvix_mutex_unlock(&set->lock);
+
+#ifdef CACHE_DEBUG
+	uprintf("[benchmark] %d misses, %d hits", stats.nmisses, stats.nhits);
 #endif
-	int ref_count;
-} cache_slot;
+	return (err);
+}
 
-static cache_slot cache_lines[RMEM_CACHE_SIZE] = {
-	[0 ... ((RMEM_CACHE_SIZE) - 1)] = {.pgnum = RMEM_NULL, .age = 0, .ref_count = 0}
-};
+/*============================================================================*
+ * nanvix_rcache_dirty()                                                      *
+ *============================================================================*/
 
 /**
- * @brief Discrete cache time.
+ * @brief Marks a cached remote page as modified.
+ *
+ * Only pages marked as modified are written back to remote memory
+ * when they get evicted from the cache.
  */
-static unsigned cache_time = 0;
+int nanvix_rcache_dirty(rpage_t pgnum)
+{
+	int idx;
+	struct cache_set *set;
 
-#ifdef __RMEM_CACHE_FIFO
-	static int cache_policy = RMEM_CACHE_FIFO;
-#elif defined(__RMEM_CACHE_LRU)
-	static int cache_policy = RMEM_CACHE_LRU;
-#elif defined(__RMEM_CACHE_AGING)
-	static int cache_policy = RMEM_CACHE_AGING;
-#elif defined(__RMEM_CACHE_LIFO)
-	static int cache_policy = RMEM_CACHE_LIFO;
-#else
-	static int cache_policy = RMEM_CACHE_FIFO;
-#endif
+	/* Invalid page number. */
+	if ((pgnum == RMEM_NULL) || (RMEM_BLOCK_NUM(pgnum) >= RMEM_NUM_BLOCKS))
+		return (-EFAULT);
 
-#ifdef __RMEM_CACHE_WRITE_BACK
-	static int write_num = RMEM_CACHE_WRITE_BACK;
-#elif defined(__RMEM_CACHE_WRITE_THROUGH)
-	static int write_num = RMEM_CACHE_WRITE_THROUGH;
-#else
-	static int write_num = RMEM_CACHE_WRITE_BACK;
-#endif
+	/* Search for page in the cache. */
+	if ((idx = nanvix_rcache_page_lock(pgnum)) < 0)
+		return (-EFAULT);
+
+	set = nanvix_rcache_line_set(idx);
+	cache_slots[idx].flags |= RMEM_CACHE_SLOT_DIRTY;
+	nanvix_mutex_unlock(&set->lock);
+
+	return (0);
+}
 
 /*============================================================================*
- * nanvix_rcache_clean()                                                      *
+ * nanvix_rcache_free()                                                       *
  *============================================================================*/
 
 /**
- * @brief Cleans the cache.
+ * @todo TODO: provide a detailed description for this function.
  */
-void nanvix_rcache_clean(void)
+int nanvix_rcache_free(rpage_t pgnum)
 {
-	for (int i = 0; i < RMEM_CACHE_LENGTH*RMEM_CACHE_BLOCK_SIZE; i++)
+	int idx;
+	struct cache_set *set;
+
+	/* Invalid page number. */
+	if ((pgnum == RMEM_NULL) || (RMEM_BLOCK_NUM(pgnum) >= RMEM_NUM_BLOCKS))
+		return (-EFAULT);
+
+	/* Check if target page is loaded into the cache. */
+	if ((idx = nanvix_rcache_page_lock(pgnum)) >= 0)
 	{
-		cache_lines[i].pgnum = RMEM_NULL;
-		cache_lines[i].age = 0;
+		set = nanvix_rcache_line_set(idx);
+
+		nanvix_mutex_lock(&cache_lock);
+
+			/* A line is not reachable without its first page. */
+			if ((idx%cache_block_size) == 0)
+				nanvix_rcache_line_invalidate(idx);
+			else
+			{
+				nanvix_rcache_hash_remove(idx);
+				cache_slots[idx].pgnum = RMEM_NULL;
+				cache_slots[idx].ref_count = 0;
+				cache_slots[idx].flags = 0;
+			}
+
+		nanvix_mutex_unlock(&cache_lock);
+
+		nanvix_mutex_unlock(&set->lock);
 	}
+
+	nanvix_rcache_wb_cancel(pgnum, NULL);
+	nanvix_rcache_victim_remove(pgnum);
+
+	nanvix_mutex_lock(&cache_lock);
+		nanvix_rcache_ghost_remove(pgnum);
+		bitmap_clear(cache_pages[RMEM_BLOCK_SERVER(pgnum)], RMEM_BLOCK_NUM(pgnum));
+	nanvix_mutex_unlock(&cache_lock);
+
+	nanvix_rcache_zero_clear(pgnum);
+
+	nanvix_mutex_lock(&stats_lock);
+		stats.heat[RMEM_BLOCK_SERVER(pgnum)][RMEM_BLOCK_NUM(pgnum)] = 0;
+		stats.nallocs--;
+	nanvix_mutex_unlock(&stats_lock);
+
+	return (nanvix_rmem_free(pgnum));
 }
 
 /*============================================================================*
- * nanvix_rcache_page_search()                                                *
+ * nanvix_rcache_line_fill()                                                  *
  *============================================================================*/
 
 /**
- * @brief Searches for a page in the cache.
+ * @brief Loads a line of pages into the cache.
  *
- * @param pgnum Number of the target page.
+ * The caller should hold the lock of the target set, and it is held
+ * again when this function returns. Pages are made visible before
+ * they are read, so that other threads that look them up wait for
+ * them rather than issuing reads of their own. The lock of the set is
+ * released while pages are read, if the miss may be tracked.
  *
- * @returns Upon successful completion, the page index is
- * returned. Upon failure a negative error code is returned instead.
+ * @param pgnum Number of the first page of the line.
+ * @param set   Number of the target set.
+ * @param keep  Index of a line that should not be evicted, or
+ * RMEM_CACHE_NULL, or RMEM_CACHE_NONE. Unless it is RMEM_CACHE_NULL,
+ * the incoming page skips the admission filter.
+ *
+ * @param overwrite Is @p pgnum about to be overwritten? If so, it is
+ * not read but marked as modified.
+ *
+ * @returns Upon successful completion, the index of the first slot of
+ * the line is returned. Upon failure a negative error code is
+ * returned instead.
  */
-static int nanvix_rcache_page_search(rpage_t pgnum)
+static int nanvix_rcache_line_fill(rpage_t pgnum, int set, int keep, int overwrite)
 {
-	cache_time++;
-	int pgnum_block;
+	int idx;
+	int mshr;
+	int ghost;
+	int failed;
+	int probation;
+	size_t nread;
+	int nvictims;
+	bitmap_t pending[(RMEM_NUM_BLOCKS + BITMAP_WORD_LENGTH - 1)/BITMAP_WORD_LENGTH];
+	bitmap_t queued[(RMEM_NUM_BLOCKS + BITMAP_WORD_LENGTH - 1)/BITMAP_WORD_LENGTH];
+
+	/* Page was recently evicted from A1in. */
+	nanvix_mutex_lock(&cache_lock);
+		ghost = (cache_policy == RMEM_CACHE_2Q) && nanvix_rcache_ghost_remove(pgnum);
+	nanvix_mutex_unlock(&cache_lock);
+
+	/* Prefetched pages skip the admission filter. */
+	if ((idx = nanvix_rcache_replacement_policies(set, (keep == RMEM_CACHE_NULL) ? pgnum : RMEM_NULL, &probation)) < 0)
+		return (idx);
+
+	/* Line is still needed. */
+	if (idx == keep)
+		return (-EBUSY);
+
+	if (nanvix_rcache_line_evict(idx) < 0)
+		return (-EFAULT);
+
+	nanvix_mutex_lock(&cache_lock);
+
+		/* Drop evicted pages. */
+		if (nanvix_rcache_line_is_valid(idx))
+		{
+			nanvix_mutex_lock(&stats_lock);
+				stats.nevictions++;
+			nanvix_mutex_unlock(&stats_lock);
+		}
+		nanvix_rcache_line_invalidate(idx);
+
+		/*
+		 * Lines start at the requested page, so the next pages
+		 * may be cached in another line already. They are left
+		 * out, otherwise updates to one copy would be lost.
+		 */
+		for (int i = 0; i < cache_block_size; i++)
+		{
+			if ((i > 0) && (nanvix_rcache_page_search((rpage_t)(pgnum+i)) >= 0))
+				continue;
+
+			cache_slots[idx+i].pgnum = (rpage_t)(pgnum+i);
+			nanvix_rcache_hash_insert(idx+i);
+		}
+
+		/* Admit line. */
+		if ((cache_policy == RMEM_CACHE_2Q) && !ghost)
+		{
+			nanvix_rcache_list_push(&cache_sets[set].a1in, idx);
+			cache_slots[idx].flags |= RMEM_CACHE_SLOT_A1IN;
+		}
+		else
+			nanvix_rcache_list_push(&cache_sets[set].lru, idx);
+		cache_sets[set].nlines++;
+
+		nanvix_rcache_age_update(idx);
+
+		if (probation)
+			cache_slots[idx].flags |= RMEM_CACHE_SLOT_PROBATION;
+
+		/* Track the miss. */
+		if ((mshr = nanvix_rcache_mshr_alloc(idx)) >= 0)
+		{
+			cache_slots[idx].flags |= RMEM_CACHE_SLOT_BUSY;
+			cache_sets[set].nbusy++;
+		}
+
+	nanvix_mutex_unlock(&cache_lock);
+
+	if (mshr >= 0)
+		nanvix_mutex_unlock(&cache_sets[set].lock);
+
+	/* Load page remote page. */
+	nread = 0;
+	nvictims = 0;
+	failed = 0;
+	umemset(pending, 0, sizeof(pending));
+	umemset(queued, 0, sizeof(queued));
+	for (int i = 0; i < cache_block_size; i++)
+	{
+		/* Page is cached in another line. */
+		if (cache_slots[idx+i].pgnum == RMEM_NULL)
+			continue;
+
+		/* Page is about to be overwritten. */
+		if ((i == 0) && overwrite)
+		{
+			if (nanvix_rcache_wb_cancel(pgnum, cache_frames[idx]))
+				bitmap_set(queued, i);
+			nanvix_rcache_victim_remove(pgnum);
+			bitmap_set(pending, i);
+		}
+
+		/* Page is still waiting to be written back. */
+		else if (nanvix_rcache_wb_cancel((rpage_t)(pgnum+i), cache_frames[idx+i]))
+		{
+			nanvix_rcache_victim_remove((rpage_t)(pgnum+i));
+			bitmap_set(pending, i);
+			bitmap_set(queued, i);
+		}
+
+		/* Page was evicted recently. */
+		else if (nanvix_rcache_victim_load((rpage_t)(pgnum+i), cache_frames[idx+i]))
+			nvictims++;
+
+		/* Page was never written. */
+		else if (nanvix_rcache_zero_check((rpage_t)(pgnum+i)))
+			umemset(cache_frames[idx+i], 0, RMEM_BLOCK_SIZE);
+
+		else if (nanvix_rmem_read((rpage_t)(pgnum+i), cache_frames[idx+i]) != RMEM_BLOCK_SIZE)
+		{
+			failed = 1;
+			break;
+		}
+		else
+			nread += RMEM_BLOCK_SIZE;
+	}
+
+	nanvix_mutex_lock(&stats_lock);
+		stats.nread += nread;
+		stats.nvictim_hits += nvictims;
+	nanvix_mutex_unlock(&stats_lock);
+
+	if (mshr >= 0)
+		nanvix_mutex_lock(&cache_sets[set].lock);
+
+	nanvix_mutex_lock(&cache_lock);
 
-	for (int i = 0; i < RMEM_CACHE_LENGTH; i++)
+		if (mshr >= 0)
+		{
+			cache_slots[idx].flags &= ~RMEM_CACHE_SLOT_BUSY;
+			cache_sets[set].nbusy--;
+			nanvix_rcache_mshr_free(mshr);
+		}
+
+		for (int i = 0; (i < cache_block_size) && !failed; i++)
+		{
+			if (bitmap_check_bit(pending, i))
+				cache_slots[idx+i].flags |= RMEM_CACHE_SLOT_DIRTY;
+		}
+
+	nanvix_mutex_unlock(&cache_lock);
+
+	if (failed)
 	{
-		pgnum_block = (int)(pgnum) - (int)(cache_lines[i*RMEM_CACHE_BLOCK_SIZE].pgnum);
-		if (pgnum_block >= 0 && pgnum_block < RMEM_CACHE_BLOCK_SIZE && cache_lines[i*RMEM_CACHE_BLOCK_SIZE].pgnum != RMEM_NULL)
+		/*
+		 * Pages taken from the write-behind queue hold data that
+		 * is not in remote memory yet, so they are queued again
+		 * before the line is dropped. Failures are reported by the
+		 * next synchronization.
+		 */
+		for (int i = 0; i < cache_block_size; i++)
 		{
-			for (int j = 0; j < RMEM_CACHE_BLOCK_SIZE; j++)
+			if (!bitmap_check_bit(queued, i))
+				continue;
+
+			if ((nanvix_rcache_wb_enqueue((rpage_t)(pgnum+i), cache_frames[idx+i]) < 0) &&
+				(nanvix_rmem_write((rpage_t)(pgnum+i), cache_frames[idx+i]) != RMEM_BLOCK_SIZE))
 			{
-				if (cache_lines[i*RMEM_CACHE_BLOCK_SIZE+j].pgnum == pgnum)
-				{
-					return (i*RMEM_CACHE_BLOCK_SIZE+j);
-				}
+				nanvix_mutex_lock(&cache_wb.lock);
+					cache_wb.nerrors++;
+				nanvix_mutex_unlock(&cache_wb.lock);
 			}
 		}
+
+		nanvix_mutex_lock(&cache_lock);
+			nanvix_rcache_line_invalidate(idx);
+		nanvix_mutex_unlock(&cache_lock);
 	}
 
-	return (-EFAULT);
+	return ((failed) ? -EFAULT : idx);
 }
 
-static void nanvix_update_aging(rpage_t pgnum)
+/*============================================================================*
+ * nanvix_rcache_stream_train()                                               *
+ *============================================================================*/
+
+/**
+ * @brief Feeds an access to the stride detector.
+ *
+ * The caller should hold the cache lock.
+ *
+ * @param pgnum Number of the accessed page.
+ *
+ * @returns If the access confirms the stride of a stream, the stride
+ * is returned. Otherwise, zero is returned instead.
+ */
+static int nanvix_rcache_stream_train(rpage_t pgnum)
 {
-	int temp_age;
-	for (int i = 0; i < RMEM_CACHE_LENGTH; i++)
+	int delta;
+	int victim;
+
+	/* Access follows the stride of a stream. */
+	for (int i = 0; i < RMEM_CACHE_PREFETCH_STREAMS; i++)
+	{
+		if (cache_streams[i].last == RMEM_NULL)
+			continue;
+
+		delta = (int)(pgnum - cache_streams[i].last);
+		if ((delta != 0) && (delta == cache_streams[i].stride))
+		{
+			cache_streams[i].last = pgnum;
+			cache_streams[i].confidence++;
+			cache_streams[i].stamp = cache_time;
+			return ((cache_streams[i].confidence >= RMEM_CACHE_PREFETCH_THRESHOLD) ? delta : 0);
+		}
+	}
+
+	/* Access is close to a stream: learn a new stride. */
+	for (int i = 0; i < RMEM_CACHE_PREFETCH_STREAMS; i++)
+	{
+		if (cache_streams[i].last == RMEM_NULL)
+			continue;
+
+		delta = (int)(pgnum - cache_streams[i].last);
+		if ((delta != 0) && (delta >= -RMEM_CACHE_PREFETCH_WINDOW) && (delta <= RMEM_CACHE_PREFETCH_WINDOW))
+		{
+			cache_streams[i].last = pgnum;
+			cache_streams[i].stride = delta;
+			cache_streams[i].confidence = 0;
+			cache_streams[i].stamp = cache_time;
+			return (0);
+		}
+	}
+
+	/* Start a new stream in place of the least recently used one. */
+	victim = 0;
+	for (int i = 1; i < RMEM_CACHE_PREFETCH_STREAMS; i++)
 	{
-		temp_age = cache_lines[i*RMEM_CACHE_BLOCK_SIZE].age;
-		temp_age = (unsigned)(temp_age) >> 1;
-		if (cache_lines[i*RMEM_CACHE_BLOCK_SIZE].pgnum == pgnum)
-			temp_age = 1 << 31 | temp_age;
-		cache_lines[i*RMEM_CACHE_BLOCK_SIZE].age = temp_age;
+		if (cache_streams[i].stamp < cache_streams[victim].stamp)
+			victim = i;
 	}
+	cache_streams[victim].last = pgnum;
+	cache_streams[victim].stride = 0;
+	cache_streams[victim].confidence = 0;
+	cache_streams[victim].stamp = cache_time;
+
+	return (0);
 }
 
 /*============================================================================*
- * nanvix_rcache_age_update_lru()                                             *
+ * nanvix_rcache_stream_prefetch()                                            *
  *============================================================================*/
 
 /**
- * @brief Evicts pages from the cache based on the LRU replacement policy.
+ * @brief Reads ahead the next lines of a stream.
  *
- * @param pgnum Number of the target page.
+ * Prefetched lines are not marked as referenced, thus they are the
+ * first to go under CLOCK, and they enter A1in under 2Q.
  *
- * @returns Upon successful completion, the index of the page is
- * returned. Upon failure a negative error code is returned instead.
+ * @param pgnum  Number of the accessed page.
+ * @param stride Stride of the stream (in pages).
+ * @param keep   Index of the line that holds @p pgnum.
  */
-static int nanvix_rcache_age_update_lru(rpage_t pgnum)
+static void nanvix_rcache_stream_prefetch(rpage_t pgnum, int stride, int keep)
 {
 	int idx;
+	int set;
+	int blknum;
+	int block_size;
+	int allocated;
 
-	cache_time++;
+	nanvix_mutex_lock(&cache_lock);
+		block_size = cache_block_size;
+	nanvix_mutex_unlock(&cache_lock);
+
+	/* Lines do not overlap. */
+	if ((stride > 0) && (stride < block_size))
+		stride = block_size;
+	else if ((stride < 0) && (stride > -block_size))
+		stride = -block_size;
 
-	if (cache_policy == RMEM_CACHE_LRU)
+	for (int k = 1; k <= RMEM_CACHE_PREFETCH_DEGREE; k++)
 	{
-		if ((idx = nanvix_rcache_page_search(pgnum)) < 0)
-		    return (-EFAULT);
+		blknum = (int)RMEM_BLOCK_NUM(pgnum) + k*stride;
+
+		/* Out of range. */
+		if ((blknum <= 0) || ((blknum + block_size) > RMEM_NUM_BLOCKS))
+			return;
+
+		/* Skip lines that are cached. */
+		if ((set = nanvix_rcache_set_lock(pgnum + k*stride)) < 0)
+			continue;
+
+		/* Do not read ahead unallocated pages. */
+		allocated = 1;
+		nanvix_mutex_lock(&cache_lock);
+			for (int i = 0; i < block_size; i++)
+			{
+				if (!bitmap_check_bit(cache_pages[RMEM_BLOCK_SERVER(pgnum)], blknum + i))
+					allocated = 0;
+			}
+		nanvix_mutex_unlock(&cache_lock);
+
+		if (!allocated || ((idx = nanvix_rcache_line_fill(pgnum + k*stride, set, keep, 0)) < 0))
+		{
+			nanvix_mutex_unlock(&cache_sets[set].lock);
+			return;
+		}
+
+		cache_slots[idx].flags |= RMEM_CACHE_SLOT_PREFETCH;
+
+		nanvix_mutex_lock(&stats_lock);
+			stats.nprefetches++;
+		nanvix_mutex_unlock(&stats_lock);
+
+		nanvix_mutex_unlock(&cache_sets[set].lock);
+	}
+}
+
+/*============================================================================*
+ * nanvix_rcache_hint_load()                                                  *
+ *============================================================================*/
+
+/**
+ * @brief Loads a page that was hinted by the application.
+ *
+ * @param pgnum Number of the target page.
+ */
+static void nanvix_rcache_hint_load(rpage_t pgnum)
+{
+	int idx;
+	int set;
+	int allocated;
+
+	/* Page is cached. */
+	if ((set = nanvix_rcache_set_lock(pgnum)) < 0)
+		return;
 
-		cache_lines[idx].age += cache_time;
-	} else if (cache_policy == RMEM_CACHE_AGING) {
-		if ((idx = nanvix_rcache_page_search(pgnum)) < 0)
-		    return (-EFAULT);
+	/* Page was freed meanwhile. */
+	nanvix_mutex_lock(&cache_lock);
+		allocated = bitmap_check_bit(cache_pages[RMEM_BLOCK_SERVER(pgnum)], RMEM_BLOCK_NUM(pgnum));
+	nanvix_mutex_unlock(&cache_lock);
+
+	if (allocated && ((idx = nanvix_rcache_line_fill(pgnum, set, RMEM_CACHE_NONE, 0)) >= 0))
+	{
+		cache_slots[idx].flags |= RMEM_CACHE_SLOT_PREFETCH;
 
-		nanvix_update_aging(pgnum);
+		nanvix_mutex_lock(&stats_lock);
+			stats.nprefetches++;
+		nanvix_mutex_unlock(&stats_lock);
 	}
 
+	nanvix_mutex_unlock(&cache_sets[set].lock);
+}
+
+/*============================================================================*
+ * nanvix_rcache_prefetch()                                                   *
+ *============================================================================*/
+
+/**
+ * @brief Hints pages that are about to be accessed.
+ *
+ * Pages are queued for the prefetcher thread, and this function
+ * returns at once. Hints that do not fit in the queue are dropped.
+ */
+int nanvix_rcache_prefetch(rpage_t pgnum, int n)
+{
+	/* Invalid page number. */
+	if ((pgnum == RMEM_NULL) || (RMEM_BLOCK_NUM(pgnum) >= RMEM_NUM_BLOCKS))
+		return (-EFAULT);
+
+	/* Invalid number of pages. */
+	if ((n <= 0) || ((RMEM_BLOCK_NUM(pgnum) + n) > RMEM_NUM_BLOCKS))
+		return (-EINVAL);
+
+	nanvix_mutex_lock(&cache_hints.lock);
+
+		/* Prefetcher is running. */
+		if (cache_hints.enabled && !cache_hints.shutdown)
+		{
+			for (int i = 0; (i < n) && (cache_hints.length < RMEM_CACHE_HINT_LENGTH); i++)
+			{
+				cache_hints.pages[cache_hints.tail] = (rpage_t)(pgnum + i);
+				cache_hints.tail = (cache_hints.tail + 1) % RMEM_CACHE_HINT_LENGTH;
+				cache_hints.length++;
+
+				uassert(nanvix_semaphore_up(&cache_hints.npending) == 0);
+			}
+		}
+
+	nanvix_mutex_unlock(&cache_hints.lock);
+
 	return (0);
 }
 
 /*============================================================================*
- * nanvix_rcache_age_update()                                                 *
+ * nanvix_rcache_release()                                                    *
  *============================================================================*/
 
 /**
- * @todo TODO: provide a detailed description for this function.
+ * @brief Hints pages that are no longer needed.
+ *
+ * Lines that hold released pages are evicted before any other line
+ * of their sets, unless they are accessed again meanwhile. Pages that
+ * are not cached are ignored.
  */
-static int nanvix_rcache_age_update(rpage_t pgnum)
+int nanvix_rcache_release(rpage_t pgnum, int n)
 {
 	int idx;
+	struct cache_set *set;
 
-	cache_time++;
+	/* Invalid page number. */
+	if ((pgnum == RMEM_NULL) || (RMEM_BLOCK_NUM(pgnum) >= RMEM_NUM_BLOCKS))
+		return (-EFAULT);
 
-	if (cache_policy == RMEM_CACHE_AGING) {
-		nanvix_update_aging(pgnum);
-	} else {
-		if ((idx = nanvix_rcache_page_search(pgnum)) < 0)
-			return (-EFAULT);
+	/* Invalid number of pages. */
+	if ((n <= 0) || ((RMEM_BLOCK_NUM(pgnum) + n) > RMEM_NUM_BLOCKS))
+		return (-EINVAL);
+
+	for (int i = 0; i < n; i++)
+	{
+		/* Page is not cached. */
+		if ((idx = nanvix_rcache_page_lock((rpage_t)(pgnum + i))) < 0)
+			continue;
 
-		cache_lines[idx].age = cache_time;
+		set = nanvix_rcache_line_set(idx);
+
+			cache_slots[idx - (idx%cache_block_size)].flags |= RMEM_CACHE_SLOT_RELEASED;
+
+		nanvix_mutex_unlock(&set->lock);
 	}
-	return 0;
+
+	return (0);
 }
 
 /*============================================================================*
- * nanvix_rcache_fifo()                                                       *
+ * nanvix_rcache_access()                                                     *
  *============================================================================*/
 
 /**
- * @brief Evicts pages from the cache based on the FIFO replacement policy.
+ * @brief Gets a remote page.
  *
- * @param pgnum Number of the target page.
+ * On a hit, only the lock of the set of the page is held, besides a
+ * short lookup. On a miss, the set is locked while the line is loaded,
+ * so threads that access other sets are not blocked. Lines in use are
+ * never evicted, thus a miss in a set whose lines are all in use waits
+ * until one of them is put back. The prefetcher runs after the set is
+ * unlocked.
  *
- * @returns Upon successful completion, the index of the page is
- * returned. Upon failure a negative error code is returned instead.
+ * @param pgnum     Number of the target page.
+ * @param overwrite Is @p pgnum about to be overwritten?
+ *
+ * @returns Upon successful completion, a pointer to the frame of the
+ * page is returned. Upon failure, a NULL pointer is returned instead.
  */
-static int nanvix_rcache_fifo(void)
+static void *nanvix_rcache_access(rpage_t pgnum, int overwrite)
 {
 	int idx;
-	int age;
-	int min_age;
+	int set;
+	int line;
+	int stride;
+	int prefetched;
 
-	cache_time++;
+	/* Invalid page number. */
+	if ((pgnum == RMEM_NULL) || (RMEM_BLOCK_NUM(pgnum) >= RMEM_NUM_BLOCKS))
+		return (NULL);
 
-	/* Cache has space. */
-	for (int i = 0; i < RMEM_CACHE_LENGTH; i++)
+	while (1)
 	{
-		if (cache_lines[i*RMEM_CACHE_BLOCK_SIZE].pgnum == RMEM_NULL)
+		if ((idx = nanvix_rcache_page_lock(pgnum)) >= 0)
+		{
+			line = idx - (idx%cache_block_size);
+			set = line/(cache_ways*cache_block_size);
+
+			nanvix_rcache_age_update_lru(idx);
+			cache_slots[idx].ref_count++;
+			if (overwrite)
+				cache_slots[idx].flags |= RMEM_CACHE_SLOT_DIRTY;
+
+			/* First use of a prefetched line: keep the stream going. */
+			prefetched = (cache_slots[line].flags & RMEM_CACHE_SLOT_PREFETCH);
+			cache_slots[line].flags &= ~(RMEM_CACHE_SLOT_PREFETCH | RMEM_CACHE_SLOT_RELEASED | RMEM_CACHE_SLOT_PROBATION);
+
+			nanvix_mutex_lock(&cache_lock);
+				stride = (prefetched && cache_prefetch) ?
+					nanvix_rcache_stream_train(pgnum) : 0;
+			nanvix_mutex_unlock(&cache_lock);
+
+			nanvix_mutex_lock(&stats_lock);
+				stats.nhits++;
+				if (prefetched)
+					stats.nprefetch_hits++;
+				nanvix_rcache_stats_sample(pgnum);
+				nanvix_rcache_mrc_access(pgnum);
+				nanvix_rcache_filter_record(pgnum);
+				nanvix_rcache_duel_record(set, 0);
+			nanvix_mutex_unlock(&stats_lock);
+
+			nanvix_mutex_unlock(&cache_sets[set].lock);
+
+			if (stride != 0)
+				nanvix_rcache_stream_prefetch(pgnum, stride, line);
+
+			return (cache_frames[idx]);
+		}
+
+		/* Page was loaded by another thread. */
+		if ((set = nanvix_rcache_set_lock(pgnum)) < 0)
+			continue;
+
+		/* No line of the set may be evicted now: wait for a put. */
+		if ((idx = nanvix_rcache_line_fill(pgnum, set, RMEM_CACHE_NULL, overwrite)) == -EAGAIN)
 		{
-		    return (i*RMEM_CACHE_BLOCK_SIZE);
+			nanvix_mutex_unlock(&cache_sets[set].lock);
+			kthread_yield();
+			continue;
 		}
+
+		break;
 	}
 
-	/* No space. Make evict. */
-	min_age = cache_lines[idx = 0].age;
-	for (int i = 1; i < RMEM_CACHE_LENGTH; i++)
+	if (idx >= 0)
 	{
-		if ((age = cache_lines[i*RMEM_CACHE_BLOCK_SIZE].age) < min_age)
-		{
-		    idx = i*RMEM_CACHE_BLOCK_SIZE;
-		    min_age = age;
-		}
+		cache_slots[idx].flags |= RMEM_CACHE_SLOT_REF;
+		cache_slots[idx].ref_count++;
 	}
-	if (nanvix_rcache_flush(cache_lines[idx].pgnum) < 0)
-		return (-EFAULT);
 
-	return (idx);
+	nanvix_mutex_lock(&cache_lock);
+		stride = ((idx >= 0) && cache_prefetch) ?
+			nanvix_rcache_stream_train(pgnum) : 0;
+	nanvix_mutex_unlock(&cache_lock);
+
+	nanvix_mutex_lock(&stats_lock);
+		stats.nmisses++;
+		nanvix_rcache_stats_sample(pgnum);
+		nanvix_rcache_mrc_access(pgnum);
+		nanvix_rcache_filter_record(pgnum);
+		nanvix_rcache_duel_record(set, 1);
+	nanvix_mutex_unlock(&stats_lock);
+
+	nanvix_mutex_unlock(&cache_sets[set].lock);
+
+	if (idx < 0)
+		return (NULL);
+
+	if (stride != 0)
+		nanvix_rcache_stream_prefetch(pgnum, stride, idx);
+
+#ifdef CACHE_DEBUG
+	uprintf("[benchmark] %d misses, %d hits", stats.nmisses, stats.nhits);
+#endif
+	return (cache_frames[idx]);
 }
 
 /*============================================================================*
- * nanvix_rcache_lru()                                                        *
+ * nanvix_rcache_get()                                                        *
  *============================================================================*/
 
 /**
- * @todo TODO: provide a detailed description for this function.
+ * @brief Gets a remote page.
  */
-static int nanvix_rcache_lru(void)
+void *nanvix_rcache_get(rpage_t pgnum)
 {
-	return (nanvix_rcache_fifo());
+	return (nanvix_rcache_access(pgnum, 0));
 }
 
 /*============================================================================*
- * nanvix_rcache_lifo()                                                       *
+ * nanvix_rcache_overwrite()                                                  *
  *============================================================================*/
 
 /**
- * @brief Evicts pages from the cache based on the LIFO replacement policy.
+ * @brief Gets a remote page that is about to be overwritten.
  *
- * @param pgnum Number of the target page.
+ * Write-allocate without fetch: a miss takes a line for the page but
+ * does not read it from remote memory. Other pages of the line are
+ * loaded as usual.
+ */
+void *nanvix_rcache_overwrite(rpage_t pgnum)
+{
+	return (nanvix_rcache_access(pgnum, 1));
+}
+
+/*============================================================================*
+ * nanvix_rcache_bypass_read()                                                *
+ *============================================================================*/
+
+/**
+ * @brief Reads a remote page around the cache.
  *
- * @returns Upon successful completion, the index of the page is
- * returned. Upon failure a negative error code is returned instead.
+ * Cached pages are read from their lines, but replacement state is
+ * left untouched. Other pages are read from the write-behind queue or
+ * from remote memory with the lock of their set held, so that lines of
+ * that set do not load them meanwhile. Lines start at the page that
+ * missed, however, so a line of another set may still load the page
+ * as one of its next pages, and take it from the write-behind queue.
+ * The page is thus looked up again once it is read, and read from
+ * its line if it was loaded meanwhile.
  */
-static int nanvix_rcache_lifo(void)
+int nanvix_rcache_bypass_read(rpage_t pgnum, void *buf, size_t offset, size_t n)
 {
 	int idx;
-	int age;
-	int max_age;
+	int set;
+	int ret = 0;
+	size_t nread = 0;
 
-	cache_time++;
+	/* Invalid page number. */
+	if ((pgnum == RMEM_NULL) || (RMEM_BLOCK_NUM(pgnum) >= RMEM_NUM_BLOCKS))
+		return (-EFAULT);
 
-	/* Cache has space. */
-	for (int i = 0; i < RMEM_CACHE_LENGTH; i++)
-	{
-		if (cache_lines[i*RMEM_CACHE_BLOCK_SIZE].pgnum == RMEM_NULL)
-		    return (i*RMEM_CACHE_BLOCK_SIZE);
-	}
+	/* Invalid range. */
+	if ((buf == NULL) || (n == 0) || (offset >= RMEM_BLOCK_SIZE) || (n > (RMEM_BLOCK_SIZE - offset)))
+		return (-EINVAL);
 
-	/* No space. Make evict. */
-	max_age = cache_lines[idx = 0].age;
-	for (int i = 1; i < RMEM_CACHE_LENGTH; i++)
+	while (1)
 	{
-		if ((age = cache_lines[i*RMEM_CACHE_BLOCK_SIZE].age) > max_age)
+		/* Page is cached. */
+		if ((idx = nanvix_rcache_page_lock(pgnum)) >= 0)
 		{
-		    idx = i*RMEM_CACHE_BLOCK_SIZE;
-		    max_age = age;
+			umemcpy(buf, &cache_frames[idx][offset], n);
+			nanvix_mutex_unlock(&nanvix_rcache_line_set(idx)->lock);
+			return (0);
 		}
+
+		/* Page was loaded by another thread. */
+		if ((set = nanvix_rcache_set_lock(pgnum)) >= 0)
+			break;
 	}
 
-	if (nanvix_rcache_flush(cache_lines[idx].pgnum) < 0)
-		return (-EFAULT);
+		nanvix_mutex_lock(&cache_staging.lock);
 
-	return idx;
-}
+			if (nanvix_rcache_wb_lookup(pgnum, cache_staging.frame, 0))
+				umemcpy(buf, &cache_staging.frame[offset], n);
 
-/*============================================================================*
- * nanvix_rcache_replacement_policies()                                       *
- *============================================================================*/
+			else if (nanvix_rcache_zero_check(pgnum))
+				umemset(buf, 0, n);
 
-/**
- * @brief Selects the replacement policy function based on the
- * replacement policy number.
- *
- * @returns Upon successful completion, the free index of a page is
- * returned. Upon failure a negative error code is returned instead.
- */
-static int nanvix_rcache_replacement_policies(void)
-{
-	if (cache_policy == RMEM_CACHE_FIFO)
-		return (nanvix_rcache_fifo());
+			/* Full pages need no staging. */
+			else if (n == RMEM_BLOCK_SIZE)
+			{
+				if (nanvix_rmem_read(pgnum, buf) != RMEM_BLOCK_SIZE)
+					ret = -EFAULT;
+				nread = RMEM_BLOCK_SIZE;
+			}
 
-	if (cache_policy == RMEM_CACHE_LIFO)
-		return (nanvix_rcache_lifo());
+			else
+			{
+				if (nanvix_rmem_read(pgnum, cache_staging.frame) != RMEM_BLOCK_SIZE)
+					ret = -EFAULT;
+				else
+					umemcpy(buf, &cache_staging.frame[offset], n);
+				nread = RMEM_BLOCK_SIZE;
+			}
 
-	return (nanvix_rcache_lru());
-}
+		nanvix_mutex_unlock(&cache_staging.lock);
 
-/*============================================================================*
- * nanvix_rcache_select_replacement_policy()                                  *
- *============================================================================*/
+		nanvix_mutex_lock(&stats_lock);
+			stats.nread += nread;
+		nanvix_mutex_unlock(&stats_lock);
 
-/**
- * @todo TODO: provide a detailed description for this function.
- */
-int nanvix_rcache_select_replacement_policy(int num)
-{
-	cache_time++;
+	nanvix_mutex_unlock(&cache_sets[set].lock);
 
-	switch (num)
+	/* A line of another set loaded the page meanwhile. */
+	if ((idx = nanvix_rcache_page_lock(pgnum)) >= 0)
 	{
-		case RMEM_CACHE_FIFO:
-		case RMEM_CACHE_LIFO:
-		case RMEM_CACHE_LRU:
-			cache_policy = num;
-			break;
-		default:
-			return (-EFAULT);
+		umemcpy(buf, &cache_frames[idx][offset], n);
+		nanvix_mutex_unlock(&nanvix_rcache_line_set(idx)->lock);
+		ret = 0;
 	}
-	return (0);
+
+	return (ret);
 }
 
 /*============================================================================*
- * nanvix_rcache_select_write()                                               *
+ * nanvix_rcache_bypass_write()                                               *
  *============================================================================*/
 
 /**
- * @todo TODO: provide a detailed description for this function.
+ * @brief Writes a remote page around the cache.
+ *
+ * Cached pages are written to their lines and marked as modified, but
+ * replacement state is left untouched. Other pages are written to
+ * remote memory with the lock of their set held, so that lines of that
+ * set do not load them meanwhile. A line of another set may still load
+ * the page as one of its next pages, and its copy is updated once the
+ * page is written. A partial write
+ * first reads the page into the staging buffer, unless it is still
+ * waiting to be written back, in which case it is taken back from the
+ * write-behind queue.
  */
-int nanvix_rcache_select_write(int num)
+int nanvix_rcache_bypass_write(rpage_t pgnum, const void *buf, size_t offset, size_t n)
 {
-	cache_time++;
+	int idx;
+	int set;
+	int ret = 0;
+	size_t nread = 0;
+	const void *frame;
 
-	switch (num)
+	/* Invalid page number. */
+	if ((pgnum == RMEM_NULL) || (RMEM_BLOCK_NUM(pgnum) >= RMEM_NUM_BLOCKS))
+		return (-EFAULT);
+
+	/* Invalid range. */
+	if ((buf == NULL) || (n == 0) || (offset >= RMEM_BLOCK_SIZE) || (n > (RMEM_BLOCK_SIZE - offset)))
+		return (-EINVAL);
+
+	while (1)
 	{
-		case RMEM_CACHE_WRITE_THROUGH:
-		case RMEM_CACHE_WRITE_BACK:
-			cache_policy = num;
+		/* Page is cached. */
+		if ((idx = nanvix_rcache_page_lock(pgnum)) >= 0)
+		{
+			umemcpy(&cache_frames[idx][offset], buf, n);
+			cache_slots[idx].flags |= RMEM_CACHE_SLOT_DIRTY;
+			nanvix_mutex_unlock(&nanvix_rcache_line_set(idx)->lock);
+			return (0);
+		}
+
+		/* Page was loaded by another thread. */
+		if ((set = nanvix_rcache_set_lock(pgnum)) >= 0)
 			break;
-		default:
-			return (-EFAULT);
 	}
-	return (0);
-}
 
-/*============================================================================*
- * nanvix_rcache_ralloc()                                                     *
- *============================================================================*/
+		nanvix_mutex_lock(&cache_staging.lock);
 
-/**
- * @todo TODO: provide a detailed description for this function.
- */
-rpage_t nanvix_rcache_alloc(void)
-{
-	rpage_t pgnum;
+			frame = cache_staging.frame;
 
-	cache_time++;
+			/* Full pages need no staging. */
+			if (n == RMEM_BLOCK_SIZE)
+			{
+				nanvix_rcache_wb_cancel(pgnum, NULL);
+				frame = buf;
+			}
 
-	/* Forward allocation to remote memory. */
-	if ((pgnum = nanvix_rmem_alloc()) == (rpage_t) -ENOMEM)
-		return (RMEM_NULL);
+			else if (nanvix_rcache_wb_cancel(pgnum, cache_staging.frame))
+				umemcpy(&cache_staging.frame[offset], buf, n);
 
-	stats.nallocs++;
-	return (pgnum);
+			else if (nanvix_rcache_zero_check(pgnum))
+			{
+				umemset(cache_staging.frame, 0, RMEM_BLOCK_SIZE);
+				umemcpy(&cache_staging.frame[offset], buf, n);
+			}
+
+			else if (nanvix_rmem_read(pgnum, cache_staging.frame) == RMEM_BLOCK_SIZE)
+			{
+				umemcpy(&cache_staging.frame[offset], buf, n);
+				nread = RMEM_BLOCK_SIZE;
+			}
+
+			else
+				ret = -EFAULT;
+
+			if (ret == 0)
+			{
+				nanvix_rcache_victim_remove(pgnum);
+				nanvix_rcache_zero_clear(pgnum);
+
+				if (nanvix_rmem_write(pgnum, frame) != RMEM_BLOCK_SIZE)
+					ret = -EFAULT;
+			}
+
+		nanvix_mutex_unlock(&cache_staging.lock);
+
+		nanvix_mutex_lock(&stats_lock);
+			stats.nread += nread;
+			if (ret == 0)
+				stats.nwritten += RMEM_BLOCK_SIZE;
+		nanvix_mutex_unlock(&stats_lock);
+
+	nanvix_mutex_unlock(&cache_sets[set].lock);
+
+	/*
+	 * A line of another set may have loaded the page before it was
+	 * written, thus the copy in that line is brought up to date.
+	 */
+	if ((ret == 0) && ((idx = nanvix_rcache_page_lock(pgnum)) >= 0))
+	{
+		umemcpy(&cache_frames[idx][offset], buf, n);
+		nanvix_mutex_unlock(&nanvix_rcache_line_set(idx)->lock);
+	}
+
+	return (ret);
 }
 
 /*============================================================================*
- * nanvix_rcache_flush()                                                      *
+ * nanvix_rcache_put()                                                        *
  *============================================================================*/
 
 /**
  * @todo TODO: provide a detailed description for this function.
  */
-int nanvix_rcache_flush(rpage_t pgnum)
+int nanvix_rcache_put(rpage_t pgnum, int strike)
 {
-	int err;
 	int idx;
-	int pgnum_block;
-	int pgnum_abs;
-	int idx_abs;
-
-	cache_time++;
+	int ret = 0;
+	struct cache_set *set;
 
 	/* Invalid page number. */
 	if ((pgnum == RMEM_NULL) || (RMEM_BLOCK_NUM(pgnum) >= RMEM_NUM_BLOCKS))
 		return (-EFAULT);
 
-	/* Search for page in the cache. */
-	if ((idx = nanvix_rcache_page_search(pgnum)) < 0)
+	if ((idx = nanvix_rcache_page_lock(pgnum)) < 0)
 		return (-EFAULT);
 
-	pgnum_block = idx%RMEM_CACHE_BLOCK_SIZE;
-	pgnum_abs = (int)(pgnum - pgnum_block);
-	idx_abs = idx - pgnum_block;
-	/* Write page back to remote memory. */
-	for (int i = 0; i < RMEM_CACHE_BLOCK_SIZE; i++)
-	{
-		if ((err = nanvix_rmem_write((rpage_t)(pgnum_abs+i), cache_lines[idx_abs+i].pages)) < 0)
-			return (err);
-	}
+	UNUSED(strike);
+
+	set = nanvix_rcache_line_set(idx);
+
+	if (cache_slots[idx].ref_count <= 0)
+		ret = -EFAULT;
+
+	else if ((write_num == RMEM_CACHE_WRITE_THROUGH) && (nanvix_rcache_line_flush(pgnum, idx) < 0))
+		ret = -EFAULT;
+
+	else
+		cache_slots[idx].ref_count--;
+
+	nanvix_mutex_unlock(&set->lock);
+
 #ifdef CACHE_DEBUG
 	uprintf("[benchmark] %d misses, %d hits", stats.nmisses, stats.nhits);
 #endif
-	return (0);
+	return (ret);
 }
 
 /*============================================================================*
- * nanvix_rcache_free()                                                       *
+ * nanvix_rcache_sync()                                                       *
  *============================================================================*/
 
 /**
- * @todo TODO: provide a detailed description for this function.
+ * @brief Waits for pending prefetches and write-backs to complete.
+ *
+ * Prefetches are waited for first, since they may evict modified
+ * pages. Writes of the write-behind thread that failed since the
+ * last call are reported once, as are write-backs of queued pages
+ * whose line failed to load.
  */
-int nanvix_rcache_free(rpage_t pgnum)
+int nanvix_rcache_sync(void)
 {
-	cache_time++;
+	int busy;
+	int nerrors;
 
-	/* Invalid page number. */
-	if ((pgnum == RMEM_NULL) || (RMEM_BLOCK_NUM(pgnum) >= RMEM_NUM_BLOCKS))
-		return (-EFAULT);
+	do
+	{
+		nanvix_mutex_lock(&cache_hints.lock);
+			busy = cache_hints.enabled && ((cache_hints.length > 0) || cache_hints.busy);
+		nanvix_mutex_unlock(&cache_hints.lock);
 
-	/* Check if target page is loaded into the cache. */
-	for (int i = 0; i < RMEM_CACHE_LENGTH; i++)
+		if (busy)
+			kthread_yield();
+	} while (busy);
+
+	do
 	{
-		if (cache_lines[i].pgnum == pgnum)
-		    cache_lines[i].pgnum = RMEM_NULL;
-	}
+		nanvix_mutex_lock(&cache_wb.lock);
 
-	stats.nallocs--;
-	return (nanvix_rmem_free(pgnum));
+			busy = (cache_wb.length > 0);
+			for (int e = 0; e < RMEM_CACHE_WB_LENGTH; e++)
+			{
+				if (cache_wb.entries[e].state == RMEM_CACHE_WB_WRITING)
+					busy = 1;
+			}
+
+			nerrors = cache_wb.nerrors;
+			if (!busy)
+				cache_wb.nerrors = 0;
+
+		nanvix_mutex_unlock(&cache_wb.lock);
+
+		if (busy)
+			kthread_yield();
+	} while (busy);
+
+	return ((nerrors > 0) ? -EFAULT : 0);
 }
 
 /*============================================================================*
- * nanvix_rcache_get()                                                        *
+ * nanvix_rcache_prefetcher()                                                 *
  *============================================================================*/
 
 /**
- * @todo TODO: provide a detailed description for this function.
+ * @brief Loads pages hinted by the application.
+ *
+ * Once the prefetcher is asked to stop, pending hints are dropped, and
+ * the write-behind thread is asked to stop in turn.
  */
-void *nanvix_rcache_get(rpage_t pgnum)
+void nanvix_rcache_prefetcher(void)
 {
-	int err;
-	int idx;
+	rpage_t pgnum;
 
-	cache_time++;
+	while (1)
+	{
+		uassert(nanvix_semaphore_down(&cache_hints.npending) == 0);
 
-	/* Invalid page number. */
-	if ((pgnum == RMEM_NULL) || (RMEM_BLOCK_NUM(pgnum) >= RMEM_NUM_BLOCKS))
-		return (NULL);
+		nanvix_mutex_lock(&cache_hints.lock);
 
-	if ((idx = nanvix_rcache_page_search(pgnum)) >= 0)
-	{
-	    stats.nhits++;
-		nanvix_rcache_age_update_lru(pgnum);
-		cache_lines[idx].ref_count++;
-		return (cache_lines[idx].pages);
+			/* Stop. */
+			if (cache_hints.shutdown)
+			{
+				cache_hints.length = 0;
+				cache_hints.enabled = 0;
+				nanvix_mutex_unlock(&cache_hints.lock);
+				break;
+			}
+
+			pgnum = cache_hints.pages[cache_hints.head];
+			cache_hints.head = (cache_hints.head + 1) % RMEM_CACHE_HINT_LENGTH;
+			cache_hints.length--;
+			cache_hints.busy = 1;
+
+		nanvix_mutex_unlock(&cache_hints.lock);
+
+		nanvix_rcache_hint_load(pgnum);
+
+		nanvix_mutex_lock(&cache_hints.lock);
+			cache_hints.busy = 0;
+		nanvix_mutex_unlock(&cache_hints.lock);
 	}
 
-	stats.nmisses++;
-	if ((idx = nanvix_rcache_replacement_policies()) < 0)
-		return (NULL);
-	/* Load page remote page. */
-	for (int i = 0; i < RMEM_CACHE_BLOCK_SIZE; i++)
+	nanvix_mutex_lock(&cache_wb.lock);
+		cache_wb.shutdown = 1;
+	nanvix_mutex_unlock(&cache_wb.lock);
+
+	/* Wake up the write-behind thread. */
+	uassert(nanvix_semaphore_up(&cache_wb.npending) == 0);
+}
+
+/*============================================================================*
+ * nanvix_rcache_write_behind()                                               *
+ *============================================================================*/
+
+/**
+ * @brief Writes back pages evicted from the page cache.
+ *
+ * Entries are written in the order in which they were queued, and
+ * cancelled entries are skipped. A write that fails is counted rather
+ * than retried, and it is reported by nanvix_rcache_sync(). Once the
+ * thread is asked to stop, it drains the queue, disables write-behind
+ * and returns.
+ */
+void nanvix_rcache_write_behind(void)
+{
+	int e;
+	int err;
+	rpage_t pgnum;
+
+	while (1)
 	{
-		if ((err = nanvix_rmem_read((rpage_t)(pgnum+i), cache_lines[idx+i].pages)) < 0)
-			return (NULL);
-		cache_lines[idx+i].pgnum = (rpage_t)(pgnum+i);
-	}
+		uassert(nanvix_semaphore_down(&cache_wb.npending) == 0);
 
-	cache_lines[idx].ref_count++;
-	nanvix_rcache_age_update(pgnum);
+		nanvix_mutex_lock(&cache_wb.lock);
 
-#ifdef CACHE_DEBUG
-	uprintf("[benchmark] %d misses, %d hits", stats.nmisses, stats.nhits);
-#endif
-	return (cache_lines[idx].pages);
+			/* Queue is drained. */
+			if ((cache_wb.length == 0) && cache_wb.shutdown)
+			{
+				cache_wb.enabled = 0;
+				nanvix_mutex_unlock(&cache_wb.lock);
+				break;
+			}
+
+			e = cache_wb.head;
+			cache_wb.head = (cache_wb.head + 1) % RMEM_CACHE_WB_LENGTH;
+			cache_wb.length--;
+
+			pgnum = cache_wb.entries[e].pgnum;
+			cache_wb.entries[e].state = RMEM_CACHE_WB_WRITING;
+
+		nanvix_mutex_unlock(&cache_wb.lock);
+
+		/* Skip cancelled entries. */
+		err = (pgnum != RMEM_NULL) &&
+			(nanvix_rmem_write(pgnum, cache_wb_frames[e]) != RMEM_BLOCK_SIZE);
+
+		nanvix_mutex_lock(&cache_wb.lock);
+			if (err)
+				cache_wb.nerrors++;
+			cache_wb.entries[e].pgnum = RMEM_NULL;
+			cache_wb.entries[e].state = RMEM_CACHE_WB_FREE;
+		nanvix_mutex_unlock(&cache_wb.lock);
+
+		uassert(nanvix_semaphore_up(&cache_wb.nfree) == 0);
+	}
 }
 
 /*============================================================================*
- * nanvix_rcache_put()                                                        *
+ * __nanvix_rcache_setup()                                                    *
  *============================================================================*/
 
 /**
- * @todo TODO: provide a detailed description for this function.
+ * @brief Initializes the prefetch and write-behind queues of the page
+ * cache.
+ *
+ * Cache locks are initialized once. Queues are reset on every call,
+ * unless the write-behind thread still runs, and both threads should
+ * be spawned afterwards.
  */
-int nanvix_rcache_put(rpage_t pgnum, int strike)
+int __nanvix_rcache_setup(void)
 {
-	int idx;
+	int enabled;
 
-	cache_time++;
+	/* Initialize cache locks. */
+	if (!cache_initialized)
+	{
+		nanvix_mutex_init(&cache_lock);
+		nanvix_mutex_init(&stats_lock);
+		nanvix_mutex_init(&cache_victim.lock);
+		nanvix_mutex_init(&cache_zero.lock);
+		nanvix_mutex_init(&cache_staging.lock);
+		nanvix_mutex_init(&cache_wb.lock);
+		nanvix_mutex_init(&cache_hints.lock);
+		for (int i = 0; i < RMEM_CACHE_FRAMES; i++)
+			nanvix_mutex_init(&cache_sets[i].lock);
+		for (int i = 0; i < RMEM_CACHE_MSHR_LENGTH; i++)
+			nanvix_semaphore_init(&cache_mshr.entries[i].done, 0);
+		cache_initialized = 1;
+	}
 
-	/* Invalid page number. */
-	if ((pgnum == RMEM_NULL) || (RMEM_BLOCK_NUM(pgnum) >= RMEM_NUM_BLOCKS))
-		return (-EFAULT);
+	/* Nothing to do. */
+	nanvix_mutex_lock(&cache_wb.lock);
+		enabled = cache_wb.enabled;
+	nanvix_mutex_unlock(&cache_wb.lock);
+	if (enabled)
+		return (0);
 
-	if ((idx = nanvix_rcache_page_search(pgnum)) < 0)
-		return (-EFAULT);
+	nanvix_semaphore_init(&cache_hints.npending, 0);
 
-	if (cache_policy == RMEM_CACHE_LRU)
-		cache_lines[idx].age += strike;
+	nanvix_mutex_lock(&cache_hints.lock);
+		cache_hints.head = 0;
+		cache_hints.tail = 0;
+		cache_hints.length = 0;
+		cache_hints.busy = 0;
+		cache_hints.shutdown = 0;
+		cache_hints.enabled = 1;
+	nanvix_mutex_unlock(&cache_hints.lock);
 
-	if (cache_lines[idx].ref_count <= 0)
-		return (-EFAULT);
+	nanvix_semaphore_init(&cache_wb.nfree, RMEM_CACHE_WB_LENGTH);
+	nanvix_semaphore_init(&cache_wb.npending, 0);
 
-	if ((write_num == RMEM_CACHE_WRITE_THROUGH) && (nanvix_rcache_flush(pgnum) < 0))
-		return (-EFAULT);
+	nanvix_mutex_lock(&cache_wb.lock);
+		cache_wb.head = 0;
+		cache_wb.tail = 0;
+		cache_wb.length = 0;
+		cache_wb.nerrors = 0;
+		cache_wb.shutdown = 0;
+		cache_wb.enabled = 1;
+	nanvix_mutex_unlock(&cache_wb.lock);
 
-	cache_lines[idx].ref_count--;
+	return (0);
+}
+
+/*============================================================================*
+ * __nanvix_rcache_cleanup()                                                  *
+ *============================================================================*/
+
+/**
+ * @brief Asks the prefetcher and write-behind threads to stop.
+ *
+ * Only the prefetcher is woken up here. It drops pending hints, since
+ * loading them may evict modified pages, and then it asks the
+ * write-behind thread to stop in turn, which drains its queue first.
+ * The caller should join both threads afterwards.
+ */
+int __nanvix_rcache_cleanup(void)
+{
+	nanvix_mutex_lock(&cache_hints.lock);
+
+		/* Nothing to do. */
+		if (!cache_hints.enabled || cache_hints.shutdown)
+		{
+			nanvix_mutex_unlock(&cache_hints.lock);
+			return (0);
+		}
+
+		cache_hints.shutdown = 1;
+
+	nanvix_mutex_unlock(&cache_hints.lock);
+
+	/* Wake up the prefetcher, which stops the write-behind thread. */
+	uassert(nanvix_semaphore_up(&cache_hints.npending) == 0);
 
-#ifdef CACHE_DEBUG
-	uprintf("[benchmark] %d misses, %d hits", stats.nmisses, stats.nhits);
-#endif
 	return (0);
 }
@@ -55,6 +55,19 @@ static struct
 	[0 ... (RMEM_SERVERS_NUM - 1)] = { 0, -1, -1 }
 };
 
+/**
+ * @brief Client lock.
+ *
+ * Replies from all servers arrive at the same input mailbox, thus a
+ * request and its reply should not interleave with another thread's.
+ */
+static struct nanvix_mutex lock;
+
+/**
+ * @brief Is the client lock initialized?
+ */
+static int lock_initialized = 0;
+
 /*============================================================================*
  * nanvix_rmem_alloc()                                                        *
  *============================================================================*/
@@ -71,27 +84,157 @@ rpage_t nanvix_rmem_alloc(void)
 	msg.header.source = knode_get_num();
 	msg.header.opcode = RMEM_ALLOC;
 
-	/* Send operation header. */
-	uassert(
-		nanvix_mailbox_write(
-			server[nallocs % RMEM_SERVERS_NUM].outbox,
-			&msg, sizeof(struct rmem_message)
-		) == 0
-	);
-
-	/* Receive reply. */
-	uassert(
-		kmailbox_read(
-			stdinbox_get(),
-			&msg,
-			sizeof(struct rmem_message)
-		) == sizeof(struct rmem_message)
-	);
-
-	nallocs++;
+	nanvix_mutex_lock(&lock);
+
+		/* Send operation header. */
+		uassert(
+			nanvix_mailbox_write(
+				server[nallocs % RMEM_SERVERS_NUM].outbox,
+				&msg, sizeof(struct rmem_message)
+			) == 0
+		);
+
+		/* Receive reply. */
+		uassert(
+			kmailbox_read(
+				stdinbox_get(),
+				&msg,
+				sizeof(struct rmem_message)
+			) == sizeof(struct rmem_message)
+		);
+
+		nallocs++;
+
+	nanvix_mutex_unlock(&lock);
+
 	return (msg.blknum);
 }
 
+/*============================================================================*
+ * nanvix_rmem_alloc_n()                                                      *
+ *============================================================================*/
+
+/**
+ * @brief Allocates a batch of remote memory blocks.
+ *
+ * Servers are picked in a round-robin fashion. Numbers of the blocks
+ * are received through the input portal.
+ *
+ * @param blknums Store location for the numbers of the blocks.
+ * @param n       Number of blocks.
+ *
+ * @returns Upon successful completion, zero is returned. Upon
+ * failure, a negative error code is returned instead.
+ */
+static int nanvix_rmem_alloc_batch(rpage_t *blknums, int n)
+{
+	static unsigned nbatches = 0;
+	int serverid;
+	struct rmem_message msg;
+
+	/* Build operation header. */
+	msg.header.source = knode_get_num();
+	msg.header.opcode = RMEM_ALLOC_N;
+	msg.header.port = kthread_self();
+	msg.nblocks = n;
+
+	nanvix_mutex_lock(&lock);
+
+		serverid = (nbatches++) % RMEM_SERVERS_NUM;
+
+		/* Send operation header. */
+		uassert(
+			nanvix_mailbox_write(
+				server[serverid].outbox,
+				&msg,
+				sizeof(struct rmem_message)
+			) == 0
+		);
+
+		/* Wait acknowledge. */
+		uassert(
+			kmailbox_read(
+				stdinbox_get(),
+				&msg,
+				sizeof(struct rmem_message)
+			) == sizeof(struct rmem_message)
+		);
+
+		/* Blocks were allocated. */
+		if (msg.header.opcode == RMEM_ACK)
+		{
+			/* Receive numbers of the blocks. */
+			uassert(
+				kportal_allow(
+					stdinportal_get(),
+					rmem_servers[serverid].nodenum,
+					kthread_self()
+				) == 0
+			);
+			uassert(
+				kportal_read(
+					stdinportal_get(),
+					blknums,
+					n*sizeof(rpage_t)
+				) == (int)(n*sizeof(rpage_t))
+			);
+
+			/* Receive reply. */
+			uassert(
+				kmailbox_read(
+					stdinbox_get(),
+					&msg,
+					sizeof(struct rmem_message)
+				) == sizeof(struct rmem_message)
+			);
+		}
+
+	nanvix_mutex_unlock(&lock);
+
+	return (msg.errcode);
+}
+
+/**
+ * @brief Allocates many remote memory blocks.
+ *
+ * A batch that does not fit in a server is retried on the other
+ * servers. If a batch cannot be allocated at all, blocks of earlier
+ * batches are released.
+ */
+int nanvix_rmem_alloc_n(rpage_t *blknums, int n)
+{
+	int len;
+	int err;
+
+	/* Invalid store location. */
+	if (blknums == NULL)
+		return (-EINVAL);
+
+	/* Invalid number of blocks. */
+	if (n <= 0)
+		return (-EINVAL);
+
+	for (int i = 0; i < n; i += len)
+	{
+		len = ((n - i) < RMEM_ALLOC_N_MAX) ? (n - i) : RMEM_ALLOC_N_MAX;
+
+		err = -ENOMEM;
+		for (int j = 0; (j < RMEM_SERVERS_NUM) && (err < 0); j++)
+			err = nanvix_rmem_alloc_batch(&blknums[i], len);
+
+		/* Rollback. */
+		if (err < 0)
+		{
+			while (i-- > 0)
+				uassert(nanvix_rmem_free(blknums[i]) == 0);
+
+			return (err);
+		}
+	}
+
+	return (0);
+}
+
 /*============================================================================*
  * nanvix_rmem_free()                                                         *
  *============================================================================*/
@@ -115,23 +258,27 @@ int nanvix_rmem_free(rpage_t blknum)
 
 	serverid = RMEM_BLOCK_SERVER(blknum);
 
-	/* Send operation header. */
-	uassert(
-		nanvix_mailbox_write(
-			server[serverid].outbox,
-			&msg,
-			sizeof(struct rmem_message)
-		) == 0
-	);
-
-	/* Receive reply. */
-	uassert(
-		kmailbox_read(
-			stdinbox_get(),
-			&msg,
-			sizeof(struct rmem_message)
-		) == sizeof(struct rmem_message)
-	);
+	nanvix_mutex_lock(&lock);
+
+		/* Send operation header. */
+		uassert(
+			nanvix_mailbox_write(
+				server[serverid].outbox,
+				&msg,
+				sizeof(struct rmem_message)
+			) == 0
+		);
+
+		/* Receive reply. */
+		uassert(
+			kmailbox_read(
+				stdinbox_get(),
+				&msg,
+				sizeof(struct rmem_message)
+			) == sizeof(struct rmem_message)
+		);
+
+	nanvix_mutex_unlock(&lock);
 
 	return (msg.errcode);
 }
@@ -165,49 +312,53 @@ size_t nanvix_rmem_read(rpage_t blknum, void *buf)
 
 	serverid = RMEM_BLOCK_SERVER(blknum);
 
-	/* Send operation header. */
-	uassert(
-		nanvix_mailbox_write(
-			server[serverid].outbox,
-			&msg,
-			sizeof(struct rmem_message)
-		) == 0
-	);
-
-	/* Wait acknowledge. */
-	uassert(
-		kmailbox_read(
-			stdinbox_get(),
-			&msg,
-			sizeof(struct rmem_message)
-		) == sizeof(struct rmem_message)
-	);
-	uassert(msg.header.opcode == RMEM_ACK);
-
-	/* Receive data. */
-	uassert(
-		kportal_allow(
-			stdinportal_get(),
-			rmem_servers[serverid].nodenum,
-			kthread_self()
-		) == 0
-	);
-	uassert(
-		kportal_read(
-			stdinportal_get(),
-			buf,
-			RMEM_BLOCK_SIZE
-		) == RMEM_BLOCK_SIZE
-	);
-
-	/* Receive reply. */
-	uassert(
-		kmailbox_read(
-			stdinbox_get(),
-			&msg,
-			sizeof(struct rmem_message)
-		) == sizeof(struct rmem_message)
-	);
+	nanvix_mutex_lock(&lock);
+
+		/* Send operation header. */
+		uassert(
+			nanvix_mailbox_write(
+				server[serverid].outbox,
+				&msg,
+				sizeof(struct rmem_message)
+			) == 0
+		);
+
+		/* Wait acknowledge. */
+		uassert(
+			kmailbox_read(
+				stdinbox_get(),
+				&msg,
+				sizeof(struct rmem_message)
+			) == sizeof(struct rmem_message)
+		);
+		uassert(msg.header.opcode == RMEM_ACK);
+
+		/* Receive data. */
+		uassert(
+			kportal_allow(
+				stdinportal_get(),
+				rmem_servers[serverid].nodenum,
+				kthread_self()
+			) == 0
+		);
+		uassert(
+			kportal_read(
+				stdinportal_get(),
+				buf,
+				RMEM_BLOCK_SIZE
+			) == RMEM_BLOCK_SIZE
+		);
+
+		/* Receive reply. */
+		uassert(
+			kmailbox_read(
+				stdinbox_get(),
+				&msg,
+				sizeof(struct rmem_message)
+			) == sizeof(struct rmem_message)
+		);
+
+	nanvix_mutex_unlock(&lock);
 
 	return ((msg.errcode < 0) ? 0 : RMEM_BLOCK_SIZE);
 }
@@ -239,31 +390,35 @@ size_t nanvix_rmem_write(rpage_t blknum, const void *buf)
 
 	serverid = RMEM_BLOCK_SERVER(blknum);
 
-	/* Send operation header. */
-	uassert(
-		nanvix_mailbox_write(
-			server[serverid].outbox,
-			&msg, sizeof(struct rmem_message)
-		) == 0
-	);
-
-	/* Send data. */
-	uassert(
-		nanvix_portal_write(
-			server[serverid].outportal,
-			buf,
-			RMEM_BLOCK_SIZE
-		) == RMEM_BLOCK_SIZE
-	);
-
-	/* Receive reply. */
-	uassert(
-		kmailbox_read(
-			stdinbox_get(),
-			&msg,
-			sizeof(struct rmem_message)
-		) == sizeof(struct rmem_message)
-	);
+	nanvix_mutex_lock(&lock);
+
+		/* Send operation header. */
+		uassert(
+			nanvix_mailbox_write(
+				server[serverid].outbox,
+				&msg, sizeof(struct rmem_message)
+			) == 0
+		);
+
+		/* Send data. */
+		uassert(
+			nanvix_portal_write(
+				server[serverid].outportal,
+				buf,
+				RMEM_BLOCK_SIZE
+			) == RMEM_BLOCK_SIZE
+		);
+
+		/* Receive reply. */
+		uassert(
+			kmailbox_read(
+				stdinbox_get(),
+				&msg,
+				sizeof(struct rmem_message)
+			) == sizeof(struct rmem_message)
+		);
+
+	nanvix_mutex_unlock(&lock);
 
 	return ((msg.errcode < 0) ? 0 : RMEM_BLOCK_SIZE);
 }
@@ -287,13 +442,17 @@ int nanvix_rmem_shutdown(int servernum)
 	msg.header.source = knode_get_num();
 	msg.header.opcode = RMEM_EXIT;
 
-	/* Send operation header. */
-	uassert(
-		nanvix_mailbox_write(
-			server[servernum].outbox,
-			&msg, sizeof(struct rmem_message)
-		) == 0
-	);
+	nanvix_mutex_lock(&lock);
+
+		/* Send operation header. */
+		uassert(
+			nanvix_mailbox_write(
+				server[servernum].outbox,
+				&msg, sizeof(struct rmem_message)
+			) == 0
+		);
+
+	nanvix_mutex_unlock(&lock);
 
 	return (0);
 }
@@ -307,6 +466,12 @@ int nanvix_rmem_shutdown(int servernum)
  */
 int __nanvix_rmem_setup(void)
 {
+	if (!lock_initialized)
+	{
+		nanvix_mutex_init(&lock);
+		lock_initialized = 1;
+	}
+
 	/* Open connections to remote memory servers. */
 	for (int i = 0; i < RMEM_SERVERS_NUM; i++)
 	{
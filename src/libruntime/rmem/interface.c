@@ -31,9 +31,43 @@
 #include <stdint.h>
 
 /**
- * @brief Length of remote memory table.
+ * @name Remote memory table.
+ *
+ * The table is a radix tree of @p RMEM_TABLE_LEVELS levels, each one
+ * indexed by @p RMEM_TABLE_NODE_SHIFT bits of the remote address.
+ */
+/**@{*/
+#define RMEM_TABLE_LEVELS      3                                                /**< Number of levels.   */
+#define RMEM_TABLE_NODE_SHIFT  6                                                /**< Bits per level.     */
+#define RMEM_TABLE_NODE_LENGTH (1 << RMEM_TABLE_NODE_SHIFT)                     /**< Entries per node.   */
+#define RMEM_TABLE_NODE_MASK   (RMEM_TABLE_NODE_LENGTH - 1)                     /**< Mask of an index.   */
+#define RMEM_TABLE_LENGTH      (1 << (RMEM_TABLE_LEVELS*RMEM_TABLE_NODE_SHIFT)) /**< Number of entries.  */
+/**@}*/
+
+/**
+ * @brief Number of remote pages.
+ */
+#define RMEM_TABLE_NPAGES (RMEM_SERVERS_NUM*RMEM_NUM_BLOCKS)
+
+/**
+ * @brief Bounds a number of nodes by the number of remote pages.
  */
-#define RMEM_TABLE_LENGTH 1024
+#define RMEM_TABLE_NODES_BOUND(x) \
+	((RMEM_TABLE_NPAGES < (x)) ? RMEM_TABLE_NPAGES : (x))
+
+/**
+ * @brief Maximum number of nodes besides the root.
+ *
+ * Each mapped page needs at most one node at each of the two levels
+ * below the root, and a level has no more nodes than it can hold. As
+ * no more pages are mapped than remote memory has, the default pool
+ * never runs out.
+ */
+#ifndef __RMEM_TABLE_NODES_MAX
+#define RMEM_TABLE_NODES_MAX                                        \
+	(RMEM_TABLE_NODES_BOUND(RMEM_TABLE_NODE_LENGTH) +               \
+	 RMEM_TABLE_NODES_BOUND(RMEM_TABLE_LENGTH/RMEM_TABLE_NODE_LENGTH))
+#endif
 
 /**
  * @brief Computes a remote address.
@@ -46,16 +80,450 @@
 #define RADDR_INV(x) ((vaddr_t)(x) - UBASE_VIRT)
 
 /**
- * @brief Remote memory table
+ * @brief Node of the remote memory table.
  */
-static rpage_t rmem_table[RMEM_TABLE_LENGTH] = {
-	[0 ... (RMEM_TABLE_LENGTH - 1)] = RMEM_NULL
+struct rmem_node
+{
+	int nused;              /**< Number of entries in use. */
+	struct rmem_node *next; /**< Next free node.           */
+
+	/**
+	 * @brief Entries.
+	 */
+	union
+	{
+		struct rmem_node *children[RMEM_TABLE_NODE_LENGTH]; /**< Inner levels. */
+		rpage_t pages[RMEM_TABLE_NODE_LENGTH];              /**< Last level.   */
+	} entries;
 };
 
 /**
- * @brief Current break value for remote memory.
+ * @brief Remote memory table.
+ *
+ * Nodes below the root are taken from a pool when the first page
+ * under them is mapped, and they are given back when their last page
+ * is unmapped.
+ */
+static struct
+{
+	struct rmem_node root;                        /**< Root node.      */
+	struct rmem_node nodes[RMEM_TABLE_NODES_MAX]; /**< Pool of nodes.  */
+	struct rmem_node *free;                       /**< Free nodes.     */
+	int nfree;                                    /**< # Free nodes.   */
+	int initialized;                              /**< Is pool linked? */
+} rmem_table;
+
+/**
+ * @brief Maximum number of regions of remote memory.
+ */
+#define RMEM_REGIONS_MAX 256
+
+/**
+ * @brief List of extents of the remote memory table.
+ *
+ * Extents are sorted by their first entry, and they do not overlap.
+ */
+struct rmem_extents
+{
+	int nextents; /**< Number of extents. */
+
+	/**
+	 * @brief Extents.
+	 *
+	 * There is at most one more free extent than regions.
+	 */
+	struct
+	{
+		int base;   /**< First entry.       */
+		int npages; /**< Length (in pages). */
+	} extents[RMEM_REGIONS_MAX + 1];
+};
+
+/**
+ * @brief Allocated regions of remote memory.
+ */
+static struct rmem_extents rmem_regions = {
+	.nextents = 0
+};
+
+/**
+ * @brief Free extents of remote memory.
+ *
+ * The first entry of the table is never allocated, so that no region
+ * starts at a null address.
+ */
+static struct rmem_extents rmem_holes = {
+	.nextents = 1,
+	.extents = { [0] = { 1, RMEM_TABLE_LENGTH - 1 } }
+};
+
+/*============================================================================*
+ * nanvix_vmem_table_lookup()                                                 *
+ *============================================================================*/
+
+/**
+ * @brief Index of a remote address in a level of the remote memory table.
+ */
+#define RMEM_TABLE_INDEX(base, level) \
+	(((base) >> ((RMEM_TABLE_LEVELS - 1 - (level))*RMEM_TABLE_NODE_SHIFT)) & RMEM_TABLE_NODE_MASK)
+
+/**
+ * @brief Translates an entry of the remote memory table.
+ *
+ * @param base Entry in the remote memory table.
+ *
+ * @returns The remote page mapped at @p base, or RMEM_NULL if there
+ * is none.
+ */
+static rpage_t nanvix_vmem_table_lookup(raddr_t base)
+{
+	struct rmem_node *node = &rmem_table.root;
+
+	/* Invalid entry. */
+	if (base >= RMEM_TABLE_LENGTH)
+		return (RMEM_NULL);
+
+	for (int level = 0; level < (RMEM_TABLE_LEVELS - 1); level++)
+	{
+		if ((node = node->entries.children[RMEM_TABLE_INDEX(base, level)]) == NULL)
+			return (RMEM_NULL);
+	}
+
+	return (node->entries.pages[RMEM_TABLE_INDEX(base, RMEM_TABLE_LEVELS - 1)]);
+}
+
+/*============================================================================*
+ * nanvix_vmem_table_map()                                                    *
+ *============================================================================*/
+
+/**
+ * @brief Maps a remote page in the remote memory table.
+ *
+ * Missing nodes on the way to @p base are taken from the pool.
+ *
+ * @param base  Target entry in the remote memory table.
+ * @param pgnum Remote page.
+ *
+ * @returns Upon successful completion, zero is returned. Upon
+ * failure, a negative error code is returned instead.
+ */
+static int nanvix_vmem_table_map(raddr_t base, rpage_t pgnum)
+{
+	int nmissing = 0;
+	struct rmem_node *node;
+	struct rmem_node **child;
+
+	/* Link pool of nodes. */
+	if (!rmem_table.initialized)
+	{
+		for (int i = 0; i < RMEM_TABLE_NODES_MAX; i++)
+			rmem_table.nodes[i].next = (i + 1 < RMEM_TABLE_NODES_MAX) ? &rmem_table.nodes[i + 1] : NULL;
+		rmem_table.free = &rmem_table.nodes[0];
+		rmem_table.nfree = RMEM_TABLE_NODES_MAX;
+		rmem_table.initialized = 1;
+	}
+
+	/* Invalid entry. */
+	if ((base >= RMEM_TABLE_LENGTH) || (pgnum == RMEM_NULL))
+		return (-EINVAL);
+
+	/* Count missing nodes. */
+	node = &rmem_table.root;
+	for (int level = 0; level < (RMEM_TABLE_LEVELS - 1); level++)
+	{
+		if ((node = node->entries.children[RMEM_TABLE_INDEX(base, level)]) == NULL)
+		{
+			nmissing = RMEM_TABLE_LEVELS - 1 - level;
+			break;
+		}
+	}
+
+	/* Not enough nodes. */
+	if (nmissing > rmem_table.nfree)
+		return (-ENOMEM);
+
+	node = &rmem_table.root;
+	for (int level = 0; level < (RMEM_TABLE_LEVELS - 1); level++)
+	{
+		child = &node->entries.children[RMEM_TABLE_INDEX(base, level)];
+
+		/* Take a node from the pool. */
+		if (*child == NULL)
+		{
+			*child = rmem_table.free;
+			rmem_table.free = (*child)->next;
+			rmem_table.nfree--;
+
+			umemset(&(*child)->entries, 0, sizeof((*child)->entries));
+			(*child)->nused = 0;
+			node->nused++;
+		}
+
+		node = *child;
+	}
+
+	/* Busy entry. */
+	if (node->entries.pages[RMEM_TABLE_INDEX(base, RMEM_TABLE_LEVELS - 1)] != RMEM_NULL)
+		return (-EBUSY);
+
+	node->entries.pages[RMEM_TABLE_INDEX(base, RMEM_TABLE_LEVELS - 1)] = pgnum;
+	node->nused++;
+
+	return (0);
+}
+
+/*============================================================================*
+ * nanvix_vmem_table_unmap()                                                  *
+ *============================================================================*/
+
+/**
+ * @brief Unmaps a remote page from the remote memory table.
+ *
+ * Nodes that become empty are given back to the pool.
+ *
+ * @param base Target entry in the remote memory table.
+ */
+static void nanvix_vmem_table_unmap(raddr_t base)
+{
+	int level;
+	struct rmem_node *path[RMEM_TABLE_LEVELS];
+
+	/* Invalid entry. */
+	if (base >= RMEM_TABLE_LENGTH)
+		return;
+
+	path[0] = &rmem_table.root;
+	for (level = 1; level < RMEM_TABLE_LEVELS; level++)
+	{
+		if ((path[level] = path[level - 1]->entries.children[RMEM_TABLE_INDEX(base, level - 1)]) == NULL)
+			return;
+	}
+
+	/* Not mapped. */
+	if (path[RMEM_TABLE_LEVELS - 1]->entries.pages[RMEM_TABLE_INDEX(base, RMEM_TABLE_LEVELS - 1)] == RMEM_NULL)
+		return;
+
+	path[RMEM_TABLE_LEVELS - 1]->entries.pages[RMEM_TABLE_INDEX(base, RMEM_TABLE_LEVELS - 1)] = RMEM_NULL;
+	path[RMEM_TABLE_LEVELS - 1]->nused--;
+
+	/* Give back empty nodes. */
+	for (level = RMEM_TABLE_LEVELS - 1; (level > 0) && (path[level]->nused == 0); level--)
+	{
+		path[level - 1]->entries.children[RMEM_TABLE_INDEX(base, level - 1)] = NULL;
+		path[level - 1]->nused--;
+
+		path[level]->next = rmem_table.free;
+		rmem_table.free = path[level];
+		rmem_table.nfree++;
+	}
+}
+
+/*============================================================================*
+ * nanvix_vmem_extent_insert()                                                *
+ *============================================================================*/
+
+/**
+ * @brief Inserts an extent in a list.
+ *
+ * @param list   Target list.
+ * @param i      Position of the extent in the list.
+ * @param base   First entry of the extent in the remote memory table.
+ * @param npages Length of the extent (in pages).
  */
-static int rbrk = 1;
+static void nanvix_vmem_extent_insert(struct rmem_extents *list, int i, int base, int npages)
+{
+	for (int j = list->nextents; j > i; j--)
+		list->extents[j] = list->extents[j - 1];
+
+	list->extents[i].base = base;
+	list->extents[i].npages = npages;
+	list->nextents++;
+}
+
+/*============================================================================*
+ * nanvix_vmem_extent_remove()                                                *
+ *============================================================================*/
+
+/**
+ * @brief Removes an extent from a list.
+ *
+ * @param list Target list.
+ * @param i    Position of the extent in the list.
+ */
+static void nanvix_vmem_extent_remove(struct rmem_extents *list, int i)
+{
+	list->nextents--;
+	for (int j = i; j < list->nextents; j++)
+		list->extents[j] = list->extents[j + 1];
+}
+
+/*============================================================================*
+ * nanvix_vmem_extent_search()                                                *
+ *============================================================================*/
+
+/**
+ * @brief Searches for an extent in a list.
+ *
+ * @param list Target list.
+ * @param base First entry of the extent in the remote memory table.
+ *
+ * @returns The position of the first extent in @p list that does not
+ * start before @p base.
+ */
+static int nanvix_vmem_extent_search(const struct rmem_extents *list, int base)
+{
+	int lo = 0;
+	int hi = list->nextents;
+
+	while (lo < hi)
+	{
+		int mid = (lo + hi)/2;
+
+		if (list->extents[mid].base < base)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return (lo);
+}
+
+/*============================================================================*
+ * nanvix_vmem_region_alloc()                                                 *
+ *============================================================================*/
+
+/**
+ * @brief Allocates a region of the remote address space.
+ *
+ * The smallest free extent that fits the region is split, so that
+ * large extents are kept for large regions.
+ *
+ * @param n Length of the region (in pages).
+ *
+ * @returns Upon successful completion, the first entry of the region
+ * in the remote memory table is returned. Upon failure, a negative
+ * error code is returned instead.
+ */
+static int nanvix_vmem_region_alloc(int n)
+{
+	int i;
+	int base;
+	int best = -1;
+
+	/* Invalid region size. */
+	if (n <= 0)
+		return (-EINVAL);
+
+	/* Too many regions. */
+	if (rmem_regions.nextents == RMEM_REGIONS_MAX)
+		return (-ENOMEM);
+
+	/* Best fit. */
+	for (i = 0; i < rmem_holes.nextents; i++)
+	{
+		if (rmem_holes.extents[i].npages < n)
+			continue;
+
+		if ((best < 0) || (rmem_holes.extents[i].npages < rmem_holes.extents[best].npages))
+			best = i;
+	}
+
+	/* Not enough memory. */
+	if (best < 0)
+		return (-ENOMEM);
+
+	base = rmem_holes.extents[best].base;
+
+	/* Split free extent. */
+	if (rmem_holes.extents[best].npages == n)
+		nanvix_vmem_extent_remove(&rmem_holes, best);
+	else
+	{
+		rmem_holes.extents[best].base += n;
+		rmem_holes.extents[best].npages -= n;
+	}
+
+	i = nanvix_vmem_extent_search(&rmem_regions, base);
+	nanvix_vmem_extent_insert(&rmem_regions, i, base, n);
+
+	return (base);
+}
+
+/*============================================================================*
+ * nanvix_vmem_region_free()                                                  *
+ *============================================================================*/
+
+/**
+ * @brief Releases a region of the remote address space.
+ *
+ * The region is merged with the free extents around it.
+ *
+ * @param base First entry of the region in the remote memory table.
+ *
+ * @returns Upon successful completion, the length of the region (in
+ * pages) is returned. Upon failure, a negative error code is returned
+ * instead.
+ */
+static int nanvix_vmem_region_free(int base)
+{
+	int i;
+	int n;
+	int end;
+
+	i = nanvix_vmem_extent_search(&rmem_regions, base);
+
+	/* Not the start of a region. */
+	if ((i == rmem_regions.nextents) || (rmem_regions.extents[i].base != base))
+		return (-EFAULT);
+
+	n = rmem_regions.extents[i].npages;
+	end = base + n;
+	nanvix_vmem_extent_remove(&rmem_regions, i);
+
+	i = nanvix_vmem_extent_search(&rmem_holes, base);
+
+	/* Merge with next free extent. */
+	if ((i < rmem_holes.nextents) && (rmem_holes.extents[i].base == end))
+	{
+		end += rmem_holes.extents[i].npages;
+		nanvix_vmem_extent_remove(&rmem_holes, i);
+	}
+
+	/* Merge with previous free extent. */
+	if ((i > 0) && ((rmem_holes.extents[i - 1].base + rmem_holes.extents[i - 1].npages) == base))
+		rmem_holes.extents[i - 1].npages = end - rmem_holes.extents[i - 1].base;
+	else
+		nanvix_vmem_extent_insert(&rmem_holes, i, base, end - base);
+
+	return (n);
+}
+
+/*============================================================================*
+ * nanvix_vmem_region_find()                                                  *
+ *============================================================================*/
+
+/**
+ * @brief Searches for the region of an entry of the remote memory table.
+ *
+ * @param base Target entry in the remote memory table.
+ *
+ * @returns If @p base lies in a region, the position of that region in
+ * the list of regions is returned. Otherwise, a negative error code is
+ * returned instead.
+ */
+static int nanvix_vmem_region_find(int base)
+{
+	int i;
+
+	/* Last region that starts at or before base. */
+	i = nanvix_vmem_extent_search(&rmem_regions, base + 1) - 1;
+
+	/* Not in a region. */
+	if ((i < 0) || (base >= (rmem_regions.extents[i].base + rmem_regions.extents[i].npages)))
+		return (-EFAULT);
+
+	return (i);
+}
 
 /*============================================================================*
  * nanvix_vmem_lookup()                                                       *
@@ -64,6 +532,9 @@ static int rbrk = 1;
 /**
  * @brief Looks up a remote memory address.
  *
+ * Pages that are reserved but not yet backed by a remote page are
+ * valid addresses too.
+ *
  * @param base   Store location for base address.
  * @param offset Store location for offset address.
  * @param ptr    Remote memory address.
@@ -87,7 +558,7 @@ static int nanvix_vmem_lookup(raddr_t *base, raddr_t *offset, const void *ptr)
 		return (-EINVAL);
 
 	/* Bad remote memory address. */
-	if (rmem_table[_base] == RMEM_NULL)
+	if ((nanvix_vmem_table_lookup(_base) == RMEM_NULL) && (nanvix_vmem_region_find(_base) < 0))
 		return (-EFAULT);
 
 	_offset = ((raddr_t) ptr) & (RMEM_BLOCK_SIZE - 1);
@@ -101,104 +572,135 @@ static int nanvix_vmem_lookup(raddr_t *base, raddr_t *offset, const void *ptr)
 }
 
 /*============================================================================*
- * nanvix_vmem_expand()                                                       *
+ * nanvix_vmem_touch()                                                        *
  *============================================================================*/
 
 /**
- * @brief Increases the break value of the remote memory.
+ * @brief Backs a page of remote memory.
  *
- * @param n Number of block to expand.
+ * Reserved pages get their remote page when they are first written
+ * to, or when they are first faulted in.
  *
- * @returns Upon successful completion, the previous break value of the
- * remote memory is returned. Upon failure, a negative error code is
- * returned instead.
+ * @param base Target entry in the remote memory table.
+ *
+ * @returns The remote page mapped at @p base, or RMEM_NULL if no
+ * remote page could be allocated.
  */
-static int nanvix_vmem_expand(int n)
+static rpage_t nanvix_vmem_touch(raddr_t base)
 {
-	int old_rbrk;
+	rpage_t pgnum;
 
-	/* Invalid heap increase. */
-	if (n <= 0)
-		return (-EINVAL);
+	/* Already backed. */
+	if ((pgnum = nanvix_vmem_table_lookup(base)) != RMEM_NULL)
+		return (pgnum);
 
-	/* Not enough memory.*/
-	if ((rbrk + n) >= RMEM_TABLE_LENGTH)
-		return (-ENOMEM);
+	/* Allocate page. */
+	if ((pgnum = nanvix_rcache_alloc()) == RMEM_NULL)
+		return (RMEM_NULL);
 
-	/* Increase heap value. */
-	old_rbrk = rbrk;
-	rbrk += n;
+	if (nanvix_vmem_table_map(base, pgnum) < 0)
+	{
+		uassert(nanvix_rcache_free(pgnum) == 0);
+		return (RMEM_NULL);
+	}
 
-	return (old_rbrk);
+	return (pgnum);
 }
 
 /*============================================================================*
- * nanvix_vmem_contract()                                                     *
+ * nanvix_vmem_alloc()                                                        *
  *============================================================================*/
 
 /**
- * @brief Decreases the break value of the remote memory.
+ * @brief Allocates remote memory.
  *
- * @param n Number of block to contract.
- *
- * @returns Upon successful completion, the previous break value of the
- * remote memory is returned. Upon failure, a negative error code is
- * returned instead.
+ * A region of the remote address space is reserved, and each of its
+ * pages is backed by a remote page. Remote pages are allocated in
+ * batches, with one request per batch. Regions are released one by
+ * one, and their addresses are then reused.
  */
-static int nanvix_vmem_contract(int n)
+void *nanvix_vmem_alloc(size_t n)
 {
-	int old_rbrk;
+	int base;
+	size_t i;
+	size_t len;
+	rpage_t pgnums[RMEM_ALLOC_N_MAX];
 
-	/* Invalid heap decrease. */
-	if (n <= 0)
-		return (-EINVAL);
+	/* Invalid allocation size */
+	if ((n == 0) || (n >= RMEM_TABLE_LENGTH))
+		return (NULL);
 
-	/* Bad heap decrease. */
-	if ((rbrk - n) < 1)
-		return (-EINVAL);
+	/*
+	 * Find an empty region in the
+	 * remote memory table.
+	 */
+	if ((base = nanvix_vmem_region_alloc(n)) < 0)
+		return (NULL);
 
-	/* Increase heap value. */
-	old_rbrk = rbrk;
-	rbrk -= n;
+	for (i = 0; i < n; i += len)
+	{
+		len = ((n - i) < RMEM_ALLOC_N_MAX) ? (n - i) : RMEM_ALLOC_N_MAX;
+
+		/* Allocate pages. */
+		if (nanvix_rcache_alloc_n(pgnums, len) < 0)
+			goto error;
+
+		for (size_t j = 0; j < len; j++)
+		{
+			if (nanvix_vmem_table_map(base + i + j, pgnums[j]) == 0)
+				continue;
+
+			/* Release pages that were not mapped. */
+			for (size_t k = j; k < len; k++)
+				uassert(nanvix_rcache_free(pgnums[k]) == 0);
+
+			i += j;
+			goto error;
+		}
+	}
+
+	return ((void *) RADDR(base));
+
+error:
+
+	/* Rollback. */
+	while (i-- > 0)
+	{
+		uassert(nanvix_rcache_free(nanvix_vmem_table_lookup(base + i)) == 0);
+		nanvix_vmem_table_unmap(base + i);
+	}
+	uassert(nanvix_vmem_region_free(base) == (int) n);
 
-	return (old_rbrk);
+	return (NULL);
 }
 
 /*============================================================================*
- * nanvix_vmem_alloc()                                                        *
+ * nanvix_vmem_reserve()                                                      *
  *============================================================================*/
 
 /**
- * @todo TODO: Provide a detailed description for this function.
- * @todo TODO: Enable arbitrary remote memory allocation.
+ * @brief Reserves remote memory.
+ *
+ * Only a region of the remote address space is claimed. Pages are
+ * backed by remote pages on first touch, thus a sparse area uses only
+ * as much remote memory as it has touched pages. Pages that were not
+ * touched yet read as zeros.
  */
-void *nanvix_vmem_alloc(size_t n)
+void *nanvix_vmem_reserve(size_t n)
 {
 	int base;
-	rpage_t pgnum;
 
-	/* Invalid allocation size */
-	if (n == 0)
+	/* Invalid reservation size */
+	if ((n == 0) || (n >= RMEM_TABLE_LENGTH))
 		return (NULL);
 
 	/*
-	 * Find an empty slot in the
+	 * Find an empty region in the
 	 * remote memory table.
 	 */
-	if ((base = nanvix_vmem_expand(n)) < 0)
+	if ((base = nanvix_vmem_region_alloc(n)) < 0)
 		return (NULL);
 
-	for (size_t i = 0; i < n; i++)
-	{
-		uprintf("allocating page %d/%d", i, n);
-		/* Allocate page. */
-		if ((pgnum = nanvix_rcache_alloc()) == RMEM_NULL)
-			return (NULL);
-
-		rmem_table[base + i] = pgnum;
-	}
-
-
 	return ((void *) RADDR(base));
 }
 
@@ -207,12 +709,18 @@ void *nanvix_vmem_alloc(size_t n)
  *============================================================================*/
 
 /**
- * @todo TODO: Provide a detailed description for this function.
+ * @brief Frees remote memory.
+ *
+ * @p ptr should be the start of a region returned by
+ * nanvix_vmem_alloc(). Only the pages of that region are freed.
  */
 int nanvix_vmem_free(void *ptr)
 {
-	int err;      /* Error code.   */
-	raddr_t base; /* Base address. */
+	int i;          /* Region.          */
+	int n;          /* Number of pages. */
+	int err;        /* Error code.      */
+	raddr_t base;   /* Base address.    */
+	raddr_t offset; /* Offset address.  */
 
 	ptr = (void *)RADDR_INV(ptr);
 
@@ -221,43 +729,172 @@ int nanvix_vmem_free(void *ptr)
 		return (-EFAULT);
 
 	/* Lookup remote address. */
-	if ((err = nanvix_vmem_lookup(&base, NULL, ptr)) < 0)
+	if ((err = nanvix_vmem_lookup(&base, &offset, ptr)) < 0)
 		return (err);
 
 	/* Invalid address. */
-	if ((rbrk - base) < 1)
+	if (offset != 0)
+		return (-EFAULT);
+
+	/* Not the start of a region. */
+	if (((i = nanvix_vmem_region_find(base)) < 0) || (rmem_regions.extents[i].base != (int) base))
 		return (-EFAULT);
 
-	for (int i = base; i < rbrk; i++)
+	/*
+	 * Free pages before the region is released, so that
+	 * a failure leaves the region allocated and consistent.
+	 */
+	n = rmem_regions.extents[i].npages;
+	for (int j = base; j < (int)(base + n); j++)
 	{
+		/* Page was never touched. */
+		if (nanvix_vmem_table_lookup(j) == RMEM_NULL)
+			continue;
+
 		/* Free underlying remote page. */
-		if ((err = nanvix_rcache_free(rmem_table[i])) < 0)
+		if ((err = nanvix_rcache_free(nanvix_vmem_table_lookup(j))) < 0)
 			return (err);
 
 		/* Update remote memory table. */
-		rmem_table[i] = RMEM_NULL;
+		nanvix_vmem_table_unmap(j);
 	}
 
-	err = nanvix_vmem_contract(rbrk - base);
+	/* Release region. */
+	if ((n = nanvix_vmem_region_free(base)) < 0)
+		return (n);
 
-	return ((err < 0) ? err : 0);
+	return (0);
 }
 
 /*============================================================================*
- * nanvix_vmem_read()                                                         *
+ * nanvix_vmem_span()                                                         *
  *============================================================================*/
 
 /**
- * @todo TODO: Provide a detailed description for this function.
- * @todo TODO: Enable arbitrary read offset.
- * @todo TODO: Enable arbitrary read sizes.
+ * @brief Looks up a range of remote memory.
+ *
+ * @param base   Store location for the first entry of the range in the
+ * remote memory table.
+ * @param offset Store location for the offset in the first page.
+ * @param npages Store location for the number of pages in the range.
+ * @param ptr    Remote memory address.
+ * @param n      Length of the range (in bytes).
+ *
+ * @returns Upon successful completion, zero is returned. Upon
+ * failure, a negative error code is returned instead.
  */
-size_t nanvix_vmem_read(void *buf, const void *ptr, size_t n)
+static int nanvix_vmem_span(raddr_t *base, raddr_t *offset, size_t *npages, const void *ptr, size_t n)
+{
+	int i;
+	int err;
+	size_t left;
+
+	/* Lookup remote address. */
+	if ((err = nanvix_vmem_lookup(base, offset, ptr)) < 0)
+		return (err);
+
+	/* Invalid remote memory area. */
+	if ((i = nanvix_vmem_region_find(*base)) < 0)
+		return (-EFAULT);
+
+	/*
+	 * Range goes past its region. Bytes left in the region are
+	 * compared before anything is added to n, so that a huge
+	 * length does not wrap around.
+	 */
+	left = (size_t)(rmem_regions.extents[i].base + rmem_regions.extents[i].npages - *base)*RMEM_BLOCK_SIZE - *offset;
+	if (n > left)
+		return (-EFAULT);
+
+	*npages = (*offset + n + RMEM_BLOCK_SIZE - 1)/RMEM_BLOCK_SIZE;
+
+	return (0);
+}
+
+/*============================================================================*
+ * nanvix_vmem_prefetch()                                                     *
+ *============================================================================*/
+
+/**
+ * @brief Hints remote pages that are about to be accessed.
+ *
+ * Runs of consecutive remote pages are hinted at once, so that the
+ * prefetcher loads them while the caller copies earlier pages.
+ *
+ * @param base   First entry of the pages in the remote memory table.
+ * @param npages Number of pages.
+ */
+static void nanvix_vmem_prefetch(raddr_t base, size_t npages)
+{
+	int len = 0;
+	rpage_t pgnum;
+	rpage_t first = RMEM_NULL;
+
+	for (size_t i = 0; i < npages; i++)
+	{
+		pgnum = nanvix_vmem_table_lookup(base + i);
+
+		/* Extend run. */
+		if ((first != RMEM_NULL) && (pgnum == (rpage_t)(first + len)))
+		{
+			len++;
+			continue;
+		}
+
+		if (first != RMEM_NULL)
+			nanvix_rcache_prefetch(first, len);
+
+		first = pgnum;
+		len = 1;
+	}
+
+	if (first != RMEM_NULL)
+		nanvix_rcache_prefetch(first, len);
+}
+
+/*============================================================================*
+ * nanvix_vmem_do_read()                                                      *
+ *============================================================================*/
+
+/**
+ * @brief Number of pages hinted ahead of a read.
+ *
+ * Hints that do not fit in the hint queue are dropped, and pages that
+ * are fetched too far ahead are evicted before they are copied, so
+ * the window fits in the queue and in half of the cache.
+ */
+#ifndef __RMEM_VMEM_PREFETCH_WINDOW
+#define RMEM_VMEM_PREFETCH_WINDOW                   \
+	((RMEM_CACHE_HINT_LENGTH < (RMEM_CACHE_SIZE/2)) ? \
+		RMEM_CACHE_HINT_LENGTH : (RMEM_CACHE_SIZE/2))
+#endif
+
+/**
+ * @brief Reads data from remote memory.
+ *
+ * The range may span many pages. A window of the pages that follow
+ * the one being copied is hinted, and it slides forward as the copy
+ * advances.
+ *
+ * @param buf    Local buffer where data should be placed.
+ * @param ptr    Target remote memory area.
+ * @param n      Number of bytes to read.
+ * @param stream Should the read bypass the cache?
+ *
+ * @returns The number of bytes read from remote memory, which is
+ * smaller than @p n if a page could not be read.
+ */
+static size_t nanvix_vmem_do_read(void *buf, const void *ptr, size_t n, int stream)
 {
 	char *rptr;     /* Cached remote page. */
+	rpage_t pgnum;  /* Remote page.        */
 	int err;        /* Error code.         */
 	raddr_t base;   /* Base address.       */
 	raddr_t offset; /* Offset address.     */
+	size_t npages;  /* Number of pages.    */
+	size_t len;     /* Bytes in a page.    */
+	size_t nread;   /* Bytes read.         */
+	size_t i;       /* Page being copied.  */
 
 	ptr = (void *)RADDR_INV(ptr);
 
@@ -272,8 +909,8 @@ size_t nanvix_vmem_read(void *buf, const void *ptr, size_t n)
 		return (0);
 	}
 
-	/* Lookup remote address. */
-	if ((err = nanvix_vmem_lookup(&base, &offset, ptr)) < 0)
+	/* Lookup remote memory range. */
+	if ((err = nanvix_vmem_span(&base, &offset, &npages, ptr, n)) < 0)
 	{
 		errno = -err;
 		return (0);
@@ -286,37 +923,116 @@ size_t nanvix_vmem_read(void *buf, const void *ptr, size_t n)
 		return (0);
 	}
 
-	/* Invalid read size. */
-	if ((n > RMEM_BLOCK_SIZE) || ((offset + n) > RMEM_BLOCK_SIZE))
+	/* Open hint window. */
+	if (!stream && (npages > 1))
 	{
-		errno = EINVAL;
-		return (0);
+		nanvix_vmem_prefetch(base + 1,
+			((npages - 1) < RMEM_VMEM_PREFETCH_WINDOW) ? (npages - 1) : RMEM_VMEM_PREFETCH_WINDOW
+		);
 	}
 
-	/* Get cached remote page. */
-	if ((rptr = nanvix_rcache_get(rmem_table[base])) == NULL)
-		return (0);
+	for (i = 0, nread = 0; nread < n; i++, nread += len, base++, offset = 0)
+	{
+		/* Slide hint window. */
+		if (!stream && (i > 0) && (RMEM_VMEM_PREFETCH_WINDOW > 0) && ((i + RMEM_VMEM_PREFETCH_WINDOW) < npages))
+			nanvix_vmem_prefetch(base + RMEM_VMEM_PREFETCH_WINDOW, 1);
 
-	umemcpy(buf, &rptr[offset], n);
+		len = ((n - nread) < (RMEM_BLOCK_SIZE - offset)) ?
+			(n - nread) : (RMEM_BLOCK_SIZE - offset);
+		pgnum = nanvix_vmem_table_lookup(base);
 
-	return (n);
+		/* Page was never touched. */
+		if (pgnum == RMEM_NULL)
+		{
+			umemset(&((char *) buf)[nread], 0, len);
+			continue;
+		}
+
+		/* Read around the cache. */
+		if (stream)
+		{
+			if ((err = nanvix_rcache_bypass_read(pgnum, &((char *) buf)[nread], offset, len)) < 0)
+			{
+				errno = -err;
+				break;
+			}
+
+			continue;
+		}
+
+		/* Get cached remote page. */
+		if ((rptr = nanvix_rcache_get(pgnum)) == NULL)
+		{
+			errno = EFAULT;
+			break;
+		}
+
+		umemcpy(&((char *) buf)[nread], &rptr[offset], len);
+
+		uassert(nanvix_rcache_put(pgnum, 0) == 0);
+	}
+
+	return (nread);
 }
 
 /*============================================================================*
- * nanvix_vmem_write()                                                        *
+ * nanvix_vmem_read()                                                         *
  *============================================================================*/
 
 /**
- * @todo TODO: Provide a detailed description for this function.
- * @todo TODO: Enable arbitrary write offset.
- * @todo TODO: Enable arbitrary write sizes.
+ * @brief Reads data from remote memory through the cache.
+ *
+ * The range may start at any offset and span many pages.
  */
-size_t nanvix_vmem_write(void *ptr, const void *buf, size_t n)
+size_t nanvix_vmem_read(void *buf, const void *ptr, size_t n)
 {
-	char *rptr;     /* Cached remote page. */
-	int err;        /* Error code.         */
-	raddr_t base;   /* Base address.       */
-	raddr_t offset; /* Offset address.     */
+	return (nanvix_vmem_do_read(buf, ptr, n, 0));
+}
+
+/*============================================================================*
+ * nanvix_vmem_stream_read()                                                  *
+ *============================================================================*/
+
+/**
+ * @brief Reads data from remote memory without caching it.
+ *
+ * Data is moved from remote memory straight into @p buf, unless the
+ * page is cached already. The cache is not touched otherwise.
+ */
+size_t nanvix_vmem_stream_read(void *buf, const void *ptr, size_t n)
+{
+	return (nanvix_vmem_do_read(buf, ptr, n, 1));
+}
+
+/*============================================================================*
+ * nanvix_vmem_do_write()                                                     *
+ *============================================================================*/
+
+/**
+ * @brief Writes data to remote memory.
+ *
+ * The range may span many pages. Pages that are overwritten as a whole
+ * are not fetched, and a partial last page is hinted before the copy
+ * starts.
+ *
+ * @param ptr    Target remote memory area.
+ * @param buf    Local buffer from where data should be retrieved.
+ * @param n      Number of bytes to write.
+ * @param stream Should the write bypass the cache?
+ *
+ * @returns The number of bytes written to remote memory, which is
+ * smaller than @p n if a page could not be written.
+ */
+static size_t nanvix_vmem_do_write(void *ptr, const void *buf, size_t n, int stream)
+{
+	char *rptr;       /* Cached remote page. */
+	rpage_t pgnum;    /* Remote page.        */
+	int err;          /* Error code.         */
+	raddr_t base;     /* Base address.       */
+	raddr_t offset;   /* Offset address.     */
+	size_t npages;    /* Number of pages.    */
+	size_t len;       /* Bytes in a page.    */
+	size_t nwritten;  /* Bytes written.      */
 
 	ptr = (void *)RADDR_INV(ptr);
 
@@ -331,8 +1047,8 @@ size_t nanvix_vmem_write(void *ptr, const void *buf, size_t n)
 		return (0);
 	}
 
-	/* Lookup remote address. */
-	if ((err = nanvix_vmem_lookup(&base, &offset, ptr)) < 0)
+	/* Lookup remote memory range. */
+	if ((err = nanvix_vmem_span(&base, &offset, &npages, ptr, n)) < 0)
 	{
 		errno = -err;
 		return (0);
@@ -345,20 +1061,81 @@ size_t nanvix_vmem_write(void *ptr, const void *buf, size_t n)
 		return (0);
 	}
 
-	/* Invalid write size. */
-	if ((n > RMEM_BLOCK_SIZE) || ((offset + n) > RMEM_BLOCK_SIZE))
+	/* Last page is partially written. */
+	if (!stream && (npages > 1) && ((offset + n)%RMEM_BLOCK_SIZE != 0))
+		nanvix_vmem_prefetch(base + npages - 1, 1);
+
+	for (nwritten = 0; nwritten < n; nwritten += len, base++, offset = 0)
 	{
-		errno = EINVAL;
-		return (0);
+		len = ((n - nwritten) < (RMEM_BLOCK_SIZE - offset)) ?
+			(n - nwritten) : (RMEM_BLOCK_SIZE - offset);
+		/* Back page on first touch. */
+		if ((pgnum = nanvix_vmem_touch(base)) == RMEM_NULL)
+		{
+			errno = ENOMEM;
+			break;
+		}
+
+		/* Write around the cache. */
+		if (stream)
+		{
+			if ((err = nanvix_rcache_bypass_write(pgnum, &((const char *) buf)[nwritten], offset, len)) < 0)
+			{
+				errno = -err;
+				break;
+			}
+
+			continue;
+		}
+
+		/* Get cached remote page, which is not fetched if overwritten. */
+		rptr = (len == RMEM_BLOCK_SIZE) ?
+			nanvix_rcache_overwrite(pgnum) :
+			nanvix_rcache_get(pgnum);
+		if (rptr == NULL)
+		{
+			errno = EFAULT;
+			break;
+		}
+
+		umemcpy(&rptr[offset], &((const char *) buf)[nwritten], len);
+
+		/* Page should be written back on eviction. */
+		uassert(nanvix_rcache_dirty(pgnum) == 0);
+
+		uassert(nanvix_rcache_put(pgnum, 0) == 0);
 	}
 
-	/* Get cached remote page. */
-	if ((rptr = nanvix_rcache_get(rmem_table[base])) == NULL)
-		return (0);
+	return (nwritten);
+}
 
-	umemcpy(&rptr[offset], buf, n);
+/*============================================================================*
+ * nanvix_vmem_write()                                                        *
+ *============================================================================*/
 
-	return (n);
+/**
+ * @brief Writes data to remote memory through the cache.
+ *
+ * The range may start at any offset and span many pages.
+ */
+size_t nanvix_vmem_write(void *ptr, const void *buf, size_t n)
+{
+	return (nanvix_vmem_do_write(ptr, buf, n, 0));
+}
+
+/*============================================================================*
+ * nanvix_vmem_stream_write()                                                 *
+ *============================================================================*/
+
+/**
+ * @brief Writes data to remote memory without caching it.
+ *
+ * Data is moved from @p buf straight into remote memory, unless the
+ * page is cached already. Partial pages go through a staging buffer.
+ */
+size_t nanvix_vmem_stream_write(void *ptr, const void *buf, size_t n)
+{
+	return (nanvix_vmem_do_write(ptr, buf, n, 1));
 }
 
 /*============================================================================*
@@ -372,8 +1149,8 @@ static struct
 {
 	vaddr_t laddr; /**< Local address.                         */
 	void *raddr;   /**< Pointer to locally-mapped remote page. */
-} maps[RMEM_CACHE_SIZE] = {
-	[0 ... (RMEM_CACHE_SIZE - 1)] = { RMEM_NULL, NULL }
+} maps[RMEM_CACHE_FRAMES] = {
+	[0 ... (RMEM_CACHE_FRAMES - 1)] = { RMEM_NULL, NULL }
 };
 
 /**
@@ -381,10 +1158,11 @@ static struct
  */
 int nanvix_rfault(vaddr_t vaddr)
 {
-	int idx = 0;  /* Idex to table of page maps.  */
-	void *lptr;   /* Local pointer.               */
-	void *rptr;   /* Remote pointer.              */
-	raddr_t base; /* Base address of remote page. */
+	int idx = 0;   /* Idex to table of page maps.  */
+	void *lptr;    /* Local pointer.               */
+	void *rptr;    /* Remote pointer.              */
+	raddr_t base;  /* Base address of remote page. */
+	rpage_t pgnum; /* Remote page.                 */
 
 	vaddr &= PAGE_MASK;
 	lptr = (void *)RADDR_INV(vaddr);
@@ -393,12 +1171,19 @@ int nanvix_rfault(vaddr_t vaddr)
 	if (nanvix_vmem_lookup(&base, NULL, lptr) < 0)
 		return (-EFAULT);
 
+	/* Back page on first touch. */
+	if ((pgnum = nanvix_vmem_touch(base)) == RMEM_NULL)
+		return (-ENOMEM);
+
 	/* Get cached remote page. */
-	if ((rptr = nanvix_rcache_get(rmem_table[base])) == NULL)
+	if ((rptr = nanvix_rcache_get(pgnum)) == NULL)
 		return (-EFAULT);
 
+	/* Writes to a linked page are not tracked. */
+	uassert(nanvix_rcache_dirty(pgnum) == 0);
+
 	/* Unlink old page page from there. */
-	for (int i = 0; i < RMEM_CACHE_SIZE; i++)
+	for (int i = 0; i < RMEM_CACHE_FRAMES; i++)
 	{
 		/* Found. */
 		if (maps[i].raddr == rptr)
@@ -419,5 +1204,11 @@ done:
 	maps[idx].laddr = vaddr;
 	uassert(page_link((vaddr_t) rptr, (vaddr_t) vaddr) == 0);
 
+	/*
+	 * Linked pages are tracked by the page maps, rather than kept in
+	 * use, otherwise faults would take up every line of the cache.
+	 */
+	uassert(nanvix_rcache_put(pgnum, 0) == 0);
+
 	return (0);
 }
@@ -24,7 +24,9 @@
 
 #define __NEED_NAME_CLIENT
 #define __NEED_RMEM_CLIENT
+#define __NEED_RMEM_CACHE
 
+#include <nanvix/runtime/rmem.h>
 #include <nanvix/runtime/runtime.h>
 #include <nanvix/servers/name.h>
 #include <nanvix/servers/rmem.h>
@@ -38,6 +40,9 @@ int nanvix_shutdown(void)
 {
 	__runtime_setup(3);
 
+	/* Write back evicted pages. */
+	uassert(nanvix_rcache_sync() == 0);
+
 	/* Broadcast shutdown signal. */
 	for (int i = 0; i < RMEM_SERVERS_NUM; i++)
 		uassert(nanvix_rmem_shutdown(i) == 0);
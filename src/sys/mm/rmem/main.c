@@ -186,6 +186,87 @@ static inline rpage_t do_rmem_alloc(void)
 	return (RMEM_BLOCK(serverid, bit));
 }
 
+/*============================================================================*
+ * do_rmem_alloc_n()                                                          *
+ *============================================================================*/
+
+/**
+ * @brief Numbers of the blocks of a bulk allocation.
+ */
+static rpage_t batch[RMEM_ALLOC_N_MAX];
+
+/**
+ * @brief Handles a bulk remote memory allocation.
+ *
+ * Either all blocks are allocated or none is. On success, the numbers
+ * of the blocks are sent through a portal, right after an acknowledge.
+ *
+ * @param remote  Remote client.
+ * @param n       Number of blocks.
+ * @param outbox  Output mailbox to remote client.
+ * @param outport Output port to remote client.
+ *
+ * @returns Upon successful completion, zero is returned. Upon
+ * failure, a negative error code is returned instead.
+ */
+static inline int do_rmem_alloc_n(int remote, int n, int outbox, int outport)
+{
+	int outportal;
+	struct rmem_message msg;
+
+	/* Build operation header. */
+	msg.header.source = knode_get_num();
+	msg.header.opcode = RMEM_ACK;
+
+	rmem_debug("alloc_n() nodenum=%d n=%d",
+		remote,
+		n
+	);
+
+	/* Invalid number of blocks. */
+	if ((n <= 0) || (n > RMEM_ALLOC_N_MAX))
+	{
+		uprintf("[nanvix][rmem] invalid number of blocks");
+		return (-EINVAL);
+	}
+
+	/* Memory server is full. */
+	if ((stats.nblocks + n) > RMEM_NUM_BLOCKS)
+	{
+		uprintf("[nanvix][rmem] remote memory full");
+		return (-ENOMEM);
+	}
+
+	for (int i = 0; i < n; i++)
+		uassert((batch[i] = do_rmem_alloc()) != RMEM_NULL);
+
+	stats.nallocs += n;
+
+	uassert((outportal =
+		kportal_open(
+			knode_get_num(),
+			remote,
+			outport)
+		) >= 0
+	);
+	uassert(
+		kmailbox_write(outbox,
+			&msg,
+			sizeof(struct rmem_message)
+		) == sizeof(struct rmem_message)
+	);
+	uassert(
+		kportal_write(
+			outportal,
+			batch,
+			n*sizeof(rpage_t)
+		) == (int)(n*sizeof(rpage_t))
+	);
+	uassert(kportal_close(outportal) == 0);
+
+	return (0);
+}
+
 /*============================================================================*
  * do_rmem_free()                                                             *
  *============================================================================*/
@@ -440,6 +521,17 @@ static int do_rmem_loop(void)
 				stats.talloc += (t1 - t0);
 			    break;
 
+			/* Allocates many pages. */
+			case RMEM_ALLOC_N:
+				kclock(&t0);
+					uassert((source = kmailbox_open(msg.header.source)) >= 0);
+					msg.errcode = do_rmem_alloc_n(msg.header.source, msg.nblocks, source, msg.header.port);
+					uassert(kmailbox_write(source, &msg, sizeof(struct rmem_message)) == sizeof(struct rmem_message));
+					uassert(kmailbox_close(source) == 0);
+				kclock(&t1);
+				stats.talloc += (t1 - t0);
+				break;
+
 			/* Free frees a page. */
 			case RMEM_MEMFREE:
 				stats.nfrees++;
@@ -81,6 +81,7 @@ static void test_rmem_rcache_put_write(void)
 	nanvix_rcache_select_write(RMEM_CACHE_WRITE_THROUGH);
 	TEST_ASSERT(nanvix_rcache_put(page[0],0) == 0);
 	TEST_ASSERT(nanvix_rcache_put(page[0],0) < 0);
+	nanvix_rcache_select_write(RMEM_CACHE_WRITE_BACK);
 
 	for (int i = 0; i < RMEM_CACHE_BLOCK_SIZE; i++)
 			TEST_ASSERT((nanvix_rcache_free(page[i])) == 0);
@@ -133,6 +134,57 @@ static void test_rmem_rcache_get_flush(void)
 	nanvix_rcache_clean();
 }
 
+/*============================================================================*
+ * API Test: Cache Dirty                                                      *
+ *============================================================================*/
+
+/**
+ * @brief API Test: Cache Dirty
+ */
+static void test_rmem_rcache_dirty(void)
+{
+	nanvix_rcache_select_replacement_policy(RMEM_CACHE_FIFO);
+
+	for (int i = 0; i < (RMEM_CACHE_LENGTH+1)*RMEM_CACHE_BLOCK_SIZE; i++)
+		TEST_ASSERT((page_num[i] = nanvix_rcache_alloc()) != RMEM_NULL);
+
+	/* Only even lines are marked as modified. */
+	for (int i = 0; i < RMEM_CACHE_LENGTH; i++)
+	{
+		TEST_ASSERT((cache_data = nanvix_rcache_get(page_num[i*RMEM_CACHE_BLOCK_SIZE])) != NULL);
+		umemset(cache_data, i+1, RMEM_BLOCK_SIZE);
+		if ((i%2) == 0)
+			TEST_ASSERT(nanvix_rcache_dirty(page_num[i*RMEM_CACHE_BLOCK_SIZE]) == 0);
+		TEST_ASSERT(nanvix_rcache_put(page_num[i*RMEM_CACHE_BLOCK_SIZE], 0) == 0);
+	}
+
+	/* Dirty line is written back. */
+	TEST_ASSERT(nanvix_rcache_get(page_num[RMEM_CACHE_LENGTH*RMEM_CACHE_BLOCK_SIZE]) != NULL);
+	TEST_ASSERT(nanvix_rcache_put(page_num[RMEM_CACHE_LENGTH*RMEM_CACHE_BLOCK_SIZE], 0) == 0);
+	TEST_ASSERT((cache_data = nanvix_rcache_get(page_num[0])) != NULL);
+
+	/* Checksum */
+	for (size_t i = 0; i < RMEM_BLOCK_SIZE; i++)
+		TEST_ASSERT(cache_data[i] == (char)(1));
+	TEST_ASSERT(nanvix_rcache_put(page_num[0], 0) == 0);
+
+	/* Clean line is dropped. */
+	TEST_ASSERT((cache_data = nanvix_rcache_get(page_num[1*RMEM_CACHE_BLOCK_SIZE])) != NULL);
+
+	/* Checksum */
+	for (size_t i = 0; i < RMEM_BLOCK_SIZE; i++)
+		TEST_ASSERT(cache_data[i] == (char)(0));
+	TEST_ASSERT(nanvix_rcache_put(page_num[1*RMEM_CACHE_BLOCK_SIZE], 0) == 0);
+
+	/* Page is not cached. */
+	TEST_ASSERT(nanvix_rcache_dirty(page_num[2*RMEM_CACHE_BLOCK_SIZE]) < 0);
+
+	for (int i = 0; i < (RMEM_CACHE_LENGTH+1)*RMEM_CACHE_BLOCK_SIZE; i++)
+		TEST_ASSERT(nanvix_rcache_free(page_num[i]) == 0);
+
+	nanvix_rcache_clean();
+}
+
 /*============================================================================*
  * API Test: Cache FiFo                                                       *
  *============================================================================*/
@@ -156,6 +208,7 @@ static void test_rmem_rcache_fifo(void)
 		{
 			TEST_ASSERT((cache_data = nanvix_rcache_get(page_num[i*RMEM_CACHE_BLOCK_SIZE+j])) != NULL);
 			umemset(cache_data, i+1, RMEM_BLOCK_SIZE);
+			TEST_ASSERT(nanvix_rcache_put(page_num[i*RMEM_CACHE_BLOCK_SIZE+j], 0) == 0);
 		}
 	}
 
@@ -171,6 +224,7 @@ static void test_rmem_rcache_fifo(void)
 	/* Checksum */
 	for (size_t i = 0; i < RMEM_BLOCK_SIZE; i++)
 		TEST_ASSERT(cache_data[i] == (char)(0));
+	TEST_ASSERT(nanvix_rcache_put(page_num[RMEM_CACHE_LENGTH*RMEM_CACHE_BLOCK_SIZE], 0) == 0);
 
 	/* Check if the page was evicted */
 	TEST_ASSERT(nanvix_rcache_flush(page_num[0*RMEM_CACHE_BLOCK_SIZE]) < 0);
@@ -183,6 +237,7 @@ static void test_rmem_rcache_fifo(void)
 		/* Checksum */
 		for (size_t j = 0; j < RMEM_BLOCK_SIZE; j++)
 			TEST_ASSERT(cache_data[j] == (char)(1));
+		TEST_ASSERT(nanvix_rcache_put(page_num[0*RMEM_CACHE_BLOCK_SIZE+i], 0) == 0);
 	}
 
 	/* Check if the page was evicted */
@@ -219,6 +274,7 @@ static void test_rmem_rcache_lifo(void)
 		{
 			TEST_ASSERT((cache_data = nanvix_rcache_get(page_num[i*RMEM_CACHE_BLOCK_SIZE+j])) != NULL);
 			umemset(cache_data, i+1, RMEM_BLOCK_SIZE);
+			TEST_ASSERT(nanvix_rcache_put(page_num[i*RMEM_CACHE_BLOCK_SIZE+j], 0) == 0);
 		}
 	}
 
@@ -236,6 +292,7 @@ static void test_rmem_rcache_lifo(void)
 	{
 		TEST_ASSERT(cache_data[i] == (char)(0));
 	}
+	TEST_ASSERT(nanvix_rcache_put(page_num[RMEM_CACHE_LENGTH*RMEM_CACHE_BLOCK_SIZE], 0) == 0);
 
 	/* Check if the page was evicted */
 	TEST_ASSERT(nanvix_rcache_flush(page_num[(RMEM_CACHE_LENGTH-1)*RMEM_CACHE_BLOCK_SIZE]) < 0);
@@ -248,6 +305,7 @@ static void test_rmem_rcache_lifo(void)
 		/* Checksum */
 		for (size_t j = 0; j < RMEM_BLOCK_SIZE; j++)
 			TEST_ASSERT(cache_data[j] == (char)(RMEM_CACHE_LENGTH));
+		TEST_ASSERT(nanvix_rcache_put(page_num[(RMEM_CACHE_LENGTH-1)*RMEM_CACHE_BLOCK_SIZE+i], 0) == 0);
 	}
 
 	/* Check if the page was evicted */
@@ -285,6 +343,7 @@ static void test_rmem_rcache_lru(void)
 		{
 			TEST_ASSERT((cache_data = nanvix_rcache_get(page_num[i*RMEM_CACHE_BLOCK_SIZE+j])) != NULL);
 			umemset(cache_data, i+1, RMEM_BLOCK_SIZE);
+			TEST_ASSERT(nanvix_rcache_put(page_num[i*RMEM_CACHE_BLOCK_SIZE+j], 0) == 0);
 		}
 	}
 	for (int i = 0; i < RMEM_CACHE_LENGTH; i++)
@@ -297,6 +356,7 @@ static void test_rmem_rcache_lru(void)
 	/* Checksum */
 	for (size_t i = 0; i < RMEM_BLOCK_SIZE; i++)
 		TEST_ASSERT(cache_data[i] == (char)(0));
+	TEST_ASSERT(nanvix_rcache_put(page_num[RMEM_CACHE_LENGTH*RMEM_CACHE_BLOCK_SIZE], 0) == 0);
 
 	/* Check if the page was evicted */
 	TEST_ASSERT(nanvix_rcache_flush(page_num[0*RMEM_CACHE_BLOCK_SIZE]) < 0);
@@ -309,6 +369,7 @@ static void test_rmem_rcache_lru(void)
 		/* Checksum */
 		for (size_t j = 0; j < RMEM_BLOCK_SIZE; j++)
 			TEST_ASSERT(cache_data[j] == (char)(2));
+		TEST_ASSERT(nanvix_rcache_put(page_num[1*RMEM_CACHE_BLOCK_SIZE], 0) == 0);
 	}
 	/* Another eviction will occur */
 	for (int i = 0; i < RMEM_CACHE_BLOCK_SIZE; i++)
@@ -318,6 +379,7 @@ static void test_rmem_rcache_lru(void)
 		/* Checksum */
 		for (size_t j = 0; j < RMEM_BLOCK_SIZE; j++)
 			TEST_ASSERT(cache_data[j] == (char)(1));
+		TEST_ASSERT(nanvix_rcache_put(page_num[0*RMEM_CACHE_BLOCK_SIZE], 0) == 0);
 	}
 
 	/* Check if the page was evicted */
@@ -352,6 +414,7 @@ static void test_rmem_rcache_aging(void)
 		{
 			TEST_ASSERT((cache_data = nanvix_rcache_get(page_num[i*RMEM_CACHE_BLOCK_SIZE+j])) != NULL);
 			umemset(cache_data, i+1, RMEM_BLOCK_SIZE);
+			TEST_ASSERT(nanvix_rcache_put(page_num[i*RMEM_CACHE_BLOCK_SIZE+j], 0) == 0);
 		}
 	}
 	for (int i = 0; i < RMEM_CACHE_LENGTH; i++)
@@ -364,6 +427,7 @@ static void test_rmem_rcache_aging(void)
 	/* Checksum */
 	for (size_t i = 0; i < RMEM_BLOCK_SIZE; i++)
 		TEST_ASSERT(cache_data[i] == (char)(0));
+	TEST_ASSERT(nanvix_rcache_put(page_num[RMEM_CACHE_LENGTH*RMEM_CACHE_BLOCK_SIZE], 0) == 0);
 
 	/* Check if the page was evicted */
 	TEST_ASSERT(nanvix_rcache_flush(page_num[0*RMEM_CACHE_BLOCK_SIZE]) < 0);
@@ -376,6 +440,7 @@ static void test_rmem_rcache_aging(void)
 		/* Checksum */
 		for (size_t j = 0; j < RMEM_BLOCK_SIZE; j++)
 			TEST_ASSERT(cache_data[j] == (char)(2));
+		TEST_ASSERT(nanvix_rcache_put(page_num[1*RMEM_CACHE_BLOCK_SIZE], 0) == 0);
 	}
 	/* Another eviction will occur */
 	for (int i = 0; i < RMEM_CACHE_BLOCK_SIZE; i++)
@@ -385,6 +450,7 @@ static void test_rmem_rcache_aging(void)
 		/* Checksum */
 		for (size_t j = 0; j < RMEM_BLOCK_SIZE; j++)
 			TEST_ASSERT(cache_data[j] == (char)(1));
+		TEST_ASSERT(nanvix_rcache_put(page_num[0*RMEM_CACHE_BLOCK_SIZE], 0) == 0);
 	}
 
 	/* Check if the page was evicted */
@@ -395,6 +461,804 @@ static void test_rmem_rcache_aging(void)
 	/* TEST_ASSERT(nanvix_rcache_free(page_num[RMEM_CACHE_LENGTH*RMEM_CACHE_BLOCK_SIZE]) == 0); */
 	nanvix_rcache_clean();
 }
+
+/*============================================================================*
+ * API Test: Cache Clock                                                      *
+ *============================================================================*/
+
+/**
+ * @brief API Test: Cache Clock
+ */
+static void test_rmem_rcache_clock(void)
+{
+
+	nanvix_rcache_select_replacement_policy(RMEM_CACHE_CLOCK);
+
+	for (int i = 0; i < (RMEM_CACHE_LENGTH+1)*RMEM_CACHE_BLOCK_SIZE; i++)
+	{
+		TEST_ASSERT((page_num[i] = nanvix_rcache_alloc()) != RMEM_NULL);
+	}
+
+	for (int i = 0; i < RMEM_CACHE_LENGTH; i++)
+	{
+		for (int j = 0; j < RMEM_CACHE_BLOCK_SIZE; j++)
+		{
+			TEST_ASSERT((cache_data = nanvix_rcache_get(page_num[i*RMEM_CACHE_BLOCK_SIZE+j])) != NULL);
+			umemset(cache_data, i+1, RMEM_BLOCK_SIZE);
+			TEST_ASSERT(nanvix_rcache_put(page_num[i*RMEM_CACHE_BLOCK_SIZE+j], 0) == 0);
+		}
+	}
+	for (int i = 0; i < RMEM_CACHE_LENGTH; i++)
+		TEST_ASSERT(nanvix_rcache_flush(page_num[i]) == 0);
+
+	/* Eviction will occur */
+	/* TEST_ASSERT((page_num[RMEM_CACHE_LENGTH*RMEM_CACHE_BLOCK_SIZE] = nanvix_rcache_alloc()) != RMEM_NULL); */
+	TEST_ASSERT((cache_data = nanvix_rcache_get(page_num[RMEM_CACHE_LENGTH*RMEM_CACHE_BLOCK_SIZE])) != NULL);
+
+	/* Checksum */
+	for (size_t i = 0; i < RMEM_BLOCK_SIZE; i++)
+		TEST_ASSERT(cache_data[i] == (char)(0));
+	TEST_ASSERT(nanvix_rcache_put(page_num[RMEM_CACHE_LENGTH*RMEM_CACHE_BLOCK_SIZE], 0) == 0);
+
+	/* Check if the page was evicted */
+	TEST_ASSERT(nanvix_rcache_flush(page_num[0*RMEM_CACHE_BLOCK_SIZE]) < 0);
+
+	/* Another access on page 1 */
+	for (int i = 0; i < RMEM_CACHE_BLOCK_SIZE; i++)
+	{
+		TEST_ASSERT((cache_data = nanvix_rcache_get(page_num[1*RMEM_CACHE_BLOCK_SIZE])) != NULL);
+
+		/* Checksum */
+		for (size_t j = 0; j < RMEM_BLOCK_SIZE; j++)
+			TEST_ASSERT(cache_data[j] == (char)(2));
+		TEST_ASSERT(nanvix_rcache_put(page_num[1*RMEM_CACHE_BLOCK_SIZE], 0) == 0);
+	}
+	/* Another eviction will occur */
+	for (int i = 0; i < RMEM_CACHE_BLOCK_SIZE; i++)
+	{
+		TEST_ASSERT((cache_data = nanvix_rcache_get(page_num[0*RMEM_CACHE_BLOCK_SIZE])) != NULL);
+
+		/* Checksum */
+		for (size_t j = 0; j < RMEM_BLOCK_SIZE; j++)
+			TEST_ASSERT(cache_data[j] == (char)(1));
+		TEST_ASSERT(nanvix_rcache_put(page_num[0*RMEM_CACHE_BLOCK_SIZE], 0) == 0);
+	}
+
+	/* Check if the page was evicted */
+	TEST_ASSERT(nanvix_rcache_flush(page_num[2*RMEM_CACHE_BLOCK_SIZE]) < 0);
+
+	for (int i = 0; i < (RMEM_CACHE_LENGTH+1)*RMEM_CACHE_BLOCK_SIZE; i++)
+		TEST_ASSERT(nanvix_rcache_free(page_num[i]) == 0);
+	/* TEST_ASSERT(nanvix_rcache_free(page_num[RMEM_CACHE_LENGTH*RMEM_CACHE_BLOCK_SIZE]) == 0); */
+	nanvix_rcache_clean();
+}
+
+/*============================================================================*
+ * API Test: Cache 2Q                                                         *
+ *============================================================================*/
+
+/**
+ * @brief Number of lines touched by the 2Q test.
+ */
+#define TEST_2Q_NUM_LINES                                                     \
+	(((3*RMEM_CACHE_LENGTH*RMEM_CACHE_BLOCK_SIZE) < RMEM_NUM_BLOCKS) ?        \
+		(3*RMEM_CACHE_LENGTH) : ((RMEM_NUM_BLOCKS - 1)/RMEM_CACHE_BLOCK_SIZE))
+
+/**
+ * @brief API Test: Cache 2Q
+ */
+static void test_rmem_rcache_2q(void)
+{
+	static rpage_t pages[TEST_2Q_NUM_LINES*RMEM_CACHE_BLOCK_SIZE];
+
+	nanvix_rcache_select_replacement_policy(RMEM_CACHE_2Q);
+
+	for (int i = 0; i < TEST_2Q_NUM_LINES*RMEM_CACHE_BLOCK_SIZE; i++)
+		TEST_ASSERT((pages[i] = nanvix_rcache_alloc()) != RMEM_NULL);
+
+	/* First references fill the A1in queue. */
+	for (int i = 0; i < RMEM_CACHE_LENGTH; i++)
+	{
+		TEST_ASSERT(nanvix_rcache_get(pages[i*RMEM_CACHE_BLOCK_SIZE]) != NULL);
+		TEST_ASSERT(nanvix_rcache_put(pages[i*RMEM_CACHE_BLOCK_SIZE], 0) == 0);
+	}
+
+	/* Eviction will occur */
+	TEST_ASSERT(nanvix_rcache_get(pages[RMEM_CACHE_LENGTH*RMEM_CACHE_BLOCK_SIZE]) != NULL);
+	TEST_ASSERT(nanvix_rcache_put(pages[RMEM_CACHE_LENGTH*RMEM_CACHE_BLOCK_SIZE], 0) == 0);
+
+	/* Check if the page was evicted */
+	TEST_ASSERT(nanvix_rcache_flush(pages[0]) < 0);
+
+	/* Second reference promotes the page to the main queue. */
+	TEST_ASSERT(nanvix_rcache_get(pages[0]) != NULL);
+	TEST_ASSERT(nanvix_rcache_put(pages[0], 0) == 0);
+
+	/* Sequential sweep over new pages. */
+	for (int i = RMEM_CACHE_LENGTH + 1; i < TEST_2Q_NUM_LINES; i++)
+	{
+		TEST_ASSERT(nanvix_rcache_get(pages[i*RMEM_CACHE_BLOCK_SIZE]) != NULL);
+		TEST_ASSERT(nanvix_rcache_put(pages[i*RMEM_CACHE_BLOCK_SIZE], 0) == 0);
+	}
+
+	/* Check if the hot page survived. */
+	TEST_ASSERT(nanvix_rcache_flush(pages[0]) == 0);
+
+	for (int i = 0; i < TEST_2Q_NUM_LINES*RMEM_CACHE_BLOCK_SIZE; i++)
+		TEST_ASSERT(nanvix_rcache_free(pages[i]) == 0);
+
+	nanvix_rcache_select_replacement_policy(RMEM_CACHE_FIFO);
+	nanvix_rcache_clean();
+}
+
+/*============================================================================*
+ * API Test: Sync                                                             *
+ *============================================================================*/
+
+/**
+ * @brief API Test: Sync
+ */
+static void test_rmem_rcache_sync(void)
+{
+	nanvix_rcache_select_replacement_policy(RMEM_CACHE_FIFO);
+
+	for (int i = 0; i < (RMEM_CACHE_LENGTH+1)*RMEM_CACHE_BLOCK_SIZE; i++)
+		TEST_ASSERT((page_num[i] = nanvix_rcache_alloc()) != RMEM_NULL);
+
+	/* Evict modified pages. */
+	for (int i = 0; i < (RMEM_CACHE_LENGTH+1)*RMEM_CACHE_BLOCK_SIZE; i++)
+	{
+		TEST_ASSERT((cache_data = nanvix_rcache_get(page_num[i])) != NULL);
+		umemset(cache_data, i+1, RMEM_BLOCK_SIZE);
+		TEST_ASSERT(nanvix_rcache_dirty(page_num[i]) == 0);
+		TEST_ASSERT(nanvix_rcache_put(page_num[i], 0) == 0);
+	}
+
+	/* Evicted pages are in remote memory. */
+	TEST_ASSERT(nanvix_rcache_sync() == 0);
+	nanvix_rcache_clean();
+
+	/* Checksum */
+	for (int i = 0; i < RMEM_CACHE_BLOCK_SIZE; i++)
+	{
+		TEST_ASSERT((cache_data = nanvix_rcache_get(page_num[i])) != NULL);
+		for (size_t j = 0; j < RMEM_BLOCK_SIZE; j++)
+			TEST_ASSERT(cache_data[j] == (char)(i+1));
+		TEST_ASSERT(nanvix_rcache_put(page_num[i], 0) == 0);
+	}
+
+	for (int i = 0; i < (RMEM_CACHE_LENGTH+1)*RMEM_CACHE_BLOCK_SIZE; i++)
+		TEST_ASSERT(nanvix_rcache_free(page_num[i]) == 0);
+	nanvix_rcache_clean();
+}
+
+/*============================================================================*
+ * API Test: Associativity                                                    *
+ *============================================================================*/
+
+/**
+ * @brief API Test: Associativity
+ */
+static void test_rmem_rcache_associativity(void)
+{
+	/* Invalid associativity. */
+	TEST_ASSERT(nanvix_rcache_select_associativity(0) < 0);
+	TEST_ASSERT(nanvix_rcache_select_associativity(RMEM_CACHE_LENGTH + 1) < 0);
+
+	for (int i = 0; i < (RMEM_CACHE_LENGTH+1)*RMEM_CACHE_BLOCK_SIZE; i++)
+		TEST_ASSERT((page_num[i] = nanvix_rcache_alloc()) != RMEM_NULL);
+
+	/* Direct-mapped cache: lines conflict. */
+	TEST_ASSERT(nanvix_rcache_select_associativity(1) == 0);
+	for (int i = 0; i < (RMEM_CACHE_LENGTH+1)*RMEM_CACHE_BLOCK_SIZE; i++)
+	{
+		TEST_ASSERT((cache_data = nanvix_rcache_get(page_num[i])) != NULL);
+		umemset(cache_data, i+1, RMEM_BLOCK_SIZE);
+		TEST_ASSERT(nanvix_rcache_dirty(page_num[i]) == 0);
+		TEST_ASSERT(nanvix_rcache_put(page_num[i], 0) == 0);
+	}
+
+	/* Held pages are not dropped. */
+	TEST_ASSERT(nanvix_rcache_get(page_num[0]) != NULL);
+	TEST_ASSERT(nanvix_rcache_select_associativity(RMEM_CACHE_WAYS) < 0);
+	TEST_ASSERT(nanvix_rcache_put(page_num[0], 0) == 0);
+
+	/* Modified pages are written back. */
+	TEST_ASSERT(nanvix_rcache_select_associativity(RMEM_CACHE_WAYS) == 0);
+
+	/* Checksum */
+	for (int i = 0; i < (RMEM_CACHE_LENGTH+1)*RMEM_CACHE_BLOCK_SIZE; i++)
+	{
+		TEST_ASSERT((cache_data = nanvix_rcache_get(page_num[i])) != NULL);
+		for (size_t j = 0; j < RMEM_BLOCK_SIZE; j++)
+			TEST_ASSERT(cache_data[j] == (char)(i+1));
+		TEST_ASSERT(nanvix_rcache_put(page_num[i], 0) == 0);
+	}
+
+	for (int i = 0; i < (RMEM_CACHE_LENGTH+1)*RMEM_CACHE_BLOCK_SIZE; i++)
+		TEST_ASSERT(nanvix_rcache_free(page_num[i]) == 0);
+	nanvix_rcache_clean();
+}
+
+/*============================================================================*
+ * API Test: Resize                                                           *
+ *============================================================================*/
+
+/**
+ * @brief API Test: Resize
+ */
+static void test_rmem_rcache_resize(void)
+{
+	/* Invalid geometry. */
+	TEST_ASSERT(nanvix_rcache_init(0, RMEM_CACHE_BLOCK_SIZE) < 0);
+	TEST_ASSERT(nanvix_rcache_init(RMEM_CACHE_LENGTH, 0) < 0);
+	TEST_ASSERT(nanvix_rcache_init(RMEM_CACHE_FRAMES + 1, 1) < 0);
+	TEST_ASSERT(nanvix_rcache_resize(0) < 0);
+
+	TEST_ASSERT(nanvix_rcache_init(RMEM_CACHE_LENGTH, RMEM_CACHE_BLOCK_SIZE) == 0);
+	nanvix_rcache_select_replacement_policy(RMEM_CACHE_FIFO);
+
+	for (int i = 0; i < (RMEM_CACHE_LENGTH+1)*RMEM_CACHE_BLOCK_SIZE; i++)
+		TEST_ASSERT((page_num[i] = nanvix_rcache_alloc()) != RMEM_NULL);
+
+	for (int i = 0; i < RMEM_CACHE_LENGTH; i++)
+	{
+		TEST_ASSERT((cache_data = nanvix_rcache_get(page_num[i*RMEM_CACHE_BLOCK_SIZE])) != NULL);
+		umemset(cache_data, i+1, RMEM_BLOCK_SIZE);
+		TEST_ASSERT(nanvix_rcache_dirty(page_num[i*RMEM_CACHE_BLOCK_SIZE]) == 0);
+		TEST_ASSERT(nanvix_rcache_put(page_num[i*RMEM_CACHE_BLOCK_SIZE], 0) == 0);
+	}
+
+	/* Shrink: lines in use are not evicted. */
+	TEST_ASSERT(nanvix_rcache_get(page_num[(RMEM_CACHE_LENGTH - 1)*RMEM_CACHE_BLOCK_SIZE]) != NULL);
+	TEST_ASSERT(nanvix_rcache_resize(RMEM_CACHE_LENGTH/2 + 1) < 0);
+	TEST_ASSERT(nanvix_rcache_put(page_num[(RMEM_CACHE_LENGTH - 1)*RMEM_CACHE_BLOCK_SIZE], 0) == 0);
+
+	/* Shrink: lines that do not fit are evicted. */
+	TEST_ASSERT(nanvix_rcache_resize(RMEM_CACHE_LENGTH/2 + 1) == 0);
+	TEST_ASSERT(nanvix_rcache_flush(page_num[0]) == 0);
+	TEST_ASSERT(nanvix_rcache_flush(page_num[(RMEM_CACHE_LENGTH - 1)*RMEM_CACHE_BLOCK_SIZE]) < 0);
+
+	/* Grow: lines are added. */
+	TEST_ASSERT(nanvix_rcache_resize(RMEM_CACHE_LENGTH) == 0);
+	for (int i = RMEM_CACHE_LENGTH/2 + 1; i < RMEM_CACHE_LENGTH; i++)
+	{
+		TEST_ASSERT((cache_data = nanvix_rcache_get(page_num[i*RMEM_CACHE_BLOCK_SIZE])) != NULL);
+
+		/* Checksum */
+		for (size_t j = 0; j < RMEM_BLOCK_SIZE; j++)
+			TEST_ASSERT(cache_data[j] == (char)(i+1));
+
+		TEST_ASSERT(nanvix_rcache_put(page_num[i*RMEM_CACHE_BLOCK_SIZE], 0) == 0);
+	}
+	TEST_ASSERT(nanvix_rcache_flush(page_num[0]) == 0);
+
+	/* Held pages are not dropped. */
+	TEST_ASSERT((cache_data = nanvix_rcache_get(page_num[0])) != NULL);
+	TEST_ASSERT(nanvix_rcache_init(RMEM_CACHE_LENGTH, RMEM_CACHE_BLOCK_SIZE) < 0);
+	TEST_ASSERT(nanvix_rcache_put(page_num[0], 0) == 0);
+	TEST_ASSERT(nanvix_rcache_select_associativity(1) == 0);
+	TEST_ASSERT((cache_data = nanvix_rcache_get(page_num[0])) != NULL);
+	TEST_ASSERT(nanvix_rcache_resize(RMEM_CACHE_LENGTH/2) < 0);
+
+	/* Checksum */
+	for (size_t j = 0; j < RMEM_BLOCK_SIZE; j++)
+		TEST_ASSERT(cache_data[j] == (char)(1));
+
+	TEST_ASSERT(nanvix_rcache_put(page_num[0], 0) == 0);
+	TEST_ASSERT(nanvix_rcache_init(RMEM_CACHE_LENGTH, RMEM_CACHE_BLOCK_SIZE) == 0);
+
+	for (int i = 0; i < (RMEM_CACHE_LENGTH+1)*RMEM_CACHE_BLOCK_SIZE; i++)
+		TEST_ASSERT(nanvix_rcache_free(page_num[i]) == 0);
+	nanvix_rcache_clean();
+}
+
+/*============================================================================*
+ * API Test: Prefetch                                                         *
+ *============================================================================*/
+
+/**
+ * @brief API Test: Prefetch
+ */
+static void test_rmem_rcache_prefetch(void)
+{
+	struct nanvix_rcache_prefetch_stats before;
+	struct nanvix_rcache_prefetch_stats after;
+
+	TEST_ASSERT(nanvix_rcache_prefetch_stats(NULL) < 0);
+
+	for (int i = 0; i < (RMEM_CACHE_LENGTH+1)*RMEM_CACHE_BLOCK_SIZE; i++)
+		TEST_ASSERT((page_num[i] = nanvix_rcache_alloc()) != RMEM_NULL);
+
+	for (int i = 0; i < RMEM_CACHE_LENGTH + 1; i++)
+	{
+		TEST_ASSERT((cache_data = nanvix_rcache_get(page_num[i*RMEM_CACHE_BLOCK_SIZE])) != NULL);
+		umemset(cache_data, i+1, RMEM_BLOCK_SIZE);
+		TEST_ASSERT(nanvix_rcache_flush(page_num[i*RMEM_CACHE_BLOCK_SIZE]) == 0);
+		TEST_ASSERT(nanvix_rcache_put(page_num[i*RMEM_CACHE_BLOCK_SIZE], 0) == 0);
+	}
+	nanvix_rcache_clean();
+
+	/* Sequential stream. */
+	TEST_ASSERT(nanvix_rcache_select_prefetch(1) == 0);
+	for (int i = 0; i < 4; i++)
+	{
+		TEST_ASSERT(nanvix_rcache_get(page_num[i*RMEM_CACHE_BLOCK_SIZE]) != NULL);
+		TEST_ASSERT(nanvix_rcache_put(page_num[i*RMEM_CACHE_BLOCK_SIZE], 0) == 0);
+	}
+
+	/* Next line was read ahead. */
+	TEST_ASSERT(nanvix_rcache_prefetch_stats(&before) == 0);
+	TEST_ASSERT((cache_data = nanvix_rcache_get(page_num[4*RMEM_CACHE_BLOCK_SIZE])) != NULL);
+	TEST_ASSERT(nanvix_rcache_prefetch_stats(&after) == 0);
+	TEST_ASSERT(after.nuseful == before.nuseful + 1);
+	TEST_ASSERT(after.nmisses == before.nmisses);
+
+	/* Checksum */
+	for (size_t i = 0; i < RMEM_BLOCK_SIZE; i++)
+		TEST_ASSERT(cache_data[i] == (char)(5));
+	TEST_ASSERT(nanvix_rcache_put(page_num[4*RMEM_CACHE_BLOCK_SIZE], 0) == 0);
+
+	TEST_ASSERT(nanvix_rcache_select_prefetch(0) == 0);
+
+	for (int i = 0; i < (RMEM_CACHE_LENGTH+1)*RMEM_CACHE_BLOCK_SIZE; i++)
+		TEST_ASSERT(nanvix_rcache_free(page_num[i]) == 0);
+	nanvix_rcache_clean();
+}
+
+/*============================================================================*
+ * API Test: Statistics                                                       *
+ *============================================================================*/
+
+/**
+ * @brief Statistics before the test.
+ */
+static struct nanvix_rcache_stats stats_before;
+
+/**
+ * @brief Statistics after the test.
+ */
+static struct nanvix_rcache_stats stats_after;
+
+/**
+ * @brief API Test: Statistics
+ */
+static void test_rmem_rcache_stats(void)
+{
+	rpage_t hot;
+
+	TEST_ASSERT(nanvix_rcache_stats(NULL) < 0);
+
+	nanvix_rcache_select_replacement_policy(RMEM_CACHE_FIFO);
+
+	for (int i = 0; i < (RMEM_CACHE_LENGTH+1)*RMEM_CACHE_BLOCK_SIZE; i++)
+		TEST_ASSERT((page_num[i] = nanvix_rcache_alloc()) != RMEM_NULL);
+
+	TEST_ASSERT(nanvix_rcache_stats(&stats_before) == 0);
+
+	/* Evict one modified line. */
+	for (int i = 0; i < RMEM_CACHE_LENGTH + 1; i++)
+	{
+		TEST_ASSERT((cache_data = nanvix_rcache_get(page_num[i*RMEM_CACHE_BLOCK_SIZE])) != NULL);
+		TEST_ASSERT(nanvix_rcache_dirty(page_num[i*RMEM_CACHE_BLOCK_SIZE]) == 0);
+		TEST_ASSERT(nanvix_rcache_put(page_num[i*RMEM_CACHE_BLOCK_SIZE], 0) == 0);
+	}
+
+	/* Heat up a page. */
+	hot = page_num[RMEM_CACHE_LENGTH*RMEM_CACHE_BLOCK_SIZE];
+	for (int i = 0; i < 2*RMEM_CACHE_HEAT_PERIOD; i++)
+	{
+		TEST_ASSERT(nanvix_rcache_get(hot) != NULL);
+		TEST_ASSERT(nanvix_rcache_put(hot, 0) == 0);
+	}
+
+	TEST_ASSERT(nanvix_rcache_stats(&stats_after) == 0);
+	TEST_ASSERT(stats_after.nmisses == stats_before.nmisses + RMEM_CACHE_LENGTH + 1);
+	TEST_ASSERT(stats_after.nhits == stats_before.nhits + 2*RMEM_CACHE_HEAT_PERIOD);
+	TEST_ASSERT(stats_after.nevictions == stats_before.nevictions + 1);
+	TEST_ASSERT(stats_after.nwritebacks == stats_before.nwritebacks + 1);
+	TEST_ASSERT(stats_after.nread == stats_before.nread);
+	TEST_ASSERT(stats_after.nwritten == stats_before.nwritten + RMEM_BLOCK_SIZE);
+	TEST_ASSERT(
+		stats_after.heat[RMEM_BLOCK_SERVER(hot)][RMEM_BLOCK_NUM(hot)] ==
+		stats_before.heat[RMEM_BLOCK_SERVER(hot)][RMEM_BLOCK_NUM(hot)] + 2
+	);
+
+	for (int i = 0; i < (RMEM_CACHE_LENGTH+1)*RMEM_CACHE_BLOCK_SIZE; i++)
+		TEST_ASSERT(nanvix_rcache_free(page_num[i]) == 0);
+	nanvix_rcache_clean();
+}
+
+/*============================================================================*
+ * API Test: Victim Tier                                                      *
+ *============================================================================*/
+
+/**
+ * @brief API Test: Victim Tier
+ */
+static void test_rmem_rcache_victim(void)
+{
+	nanvix_rcache_select_replacement_policy(RMEM_CACHE_FIFO);
+	TEST_ASSERT(nanvix_rcache_select_victim(1) == 0);
+
+	for (int i = 0; i < (RMEM_CACHE_LENGTH+1)*RMEM_CACHE_BLOCK_SIZE; i++)
+		TEST_ASSERT((page_num[i] = nanvix_rcache_alloc()) != RMEM_NULL);
+
+	/* Evict the first line. */
+	for (int i = 0; i < (RMEM_CACHE_LENGTH+1)*RMEM_CACHE_BLOCK_SIZE; i++)
+	{
+		TEST_ASSERT((cache_data = nanvix_rcache_get(page_num[i])) != NULL);
+		umemset(cache_data, i+1, RMEM_BLOCK_SIZE);
+		TEST_ASSERT(nanvix_rcache_dirty(page_num[i]) == 0);
+		TEST_ASSERT(nanvix_rcache_put(page_num[i], 0) == 0);
+	}
+
+	/* Evicted pages are loaded locally. */
+	TEST_ASSERT(nanvix_rcache_sync() == 0);
+	TEST_ASSERT(nanvix_rcache_stats(&stats_before) == 0);
+	TEST_ASSERT((cache_data = nanvix_rcache_get(page_num[0])) != NULL);
+	TEST_ASSERT(nanvix_rcache_stats(&stats_after) == 0);
+	TEST_ASSERT(stats_after.nmisses == stats_before.nmisses + 1);
+	TEST_ASSERT(stats_after.nvictim_hits == stats_before.nvictim_hits + RMEM_CACHE_BLOCK_SIZE);
+	TEST_ASSERT(stats_after.nread == stats_before.nread);
+
+	/* Checksum */
+	for (size_t j = 0; j < RMEM_BLOCK_SIZE; j++)
+		TEST_ASSERT(cache_data[j] == (char)(1));
+	TEST_ASSERT(nanvix_rcache_put(page_num[0], 0) == 0);
+
+	TEST_ASSERT(nanvix_rcache_select_victim(0) == 0);
+
+	for (int i = 0; i < (RMEM_CACHE_LENGTH+1)*RMEM_CACHE_BLOCK_SIZE; i++)
+		TEST_ASSERT(nanvix_rcache_free(page_num[i]) == 0);
+	nanvix_rcache_clean();
+}
+
+/*============================================================================*
+ * API Test: Miss Ratio Curve                                                 *
+ *============================================================================*/
+
+/**
+ * @brief API Test: Miss Ratio Curve
+ */
+static void test_rmem_rcache_mrc(void)
+{
+	int ratio;
+
+	TEST_ASSERT(nanvix_rcache_miss_ratio(0) < 0);
+	TEST_ASSERT(nanvix_rcache_miss_ratio(RMEM_CACHE_FRAMES + 1) < 0);
+	TEST_ASSERT(nanvix_rcache_autosize(-1) < 0);
+	TEST_ASSERT(nanvix_rcache_autosize(1001) < 0);
+
+	for (int i = 0; i < (RMEM_CACHE_LENGTH+1)*RMEM_CACHE_BLOCK_SIZE; i++)
+		TEST_ASSERT((page_num[i] = nanvix_rcache_alloc()) != RMEM_NULL);
+
+	/* Cyclic accesses. */
+	for (int k = 0; k < 4; k++)
+	{
+		for (int i = 0; i < (RMEM_CACHE_LENGTH+1)*RMEM_CACHE_BLOCK_SIZE; i++)
+		{
+			TEST_ASSERT(nanvix_rcache_get(page_num[i]) != NULL);
+			TEST_ASSERT(nanvix_rcache_put(page_num[i], 0) == 0);
+		}
+	}
+
+	/* Larger caches do not miss more. */
+	ratio = 1000;
+	for (int npages = 1; npages <= RMEM_CACHE_FRAMES; npages++)
+	{
+		int r;
+
+		if ((r = nanvix_rcache_miss_ratio(npages)) < 0)
+			break;
+
+		TEST_ASSERT(r <= ratio);
+		ratio = r;
+	}
+
+	/* Any size meets a miss ratio of one. */
+	if (nanvix_rcache_miss_ratio(1) >= 0)
+	{
+		TEST_ASSERT(nanvix_rcache_autosize(1000) == 1);
+		TEST_ASSERT(nanvix_rcache_get(page_num[0]) != NULL);
+		TEST_ASSERT(nanvix_rcache_put(page_num[0], 0) == 0);
+		TEST_ASSERT(nanvix_rcache_resize(RMEM_CACHE_LENGTH) == 0);
+	}
+
+	for (int i = 0; i < (RMEM_CACHE_LENGTH+1)*RMEM_CACHE_BLOCK_SIZE; i++)
+		TEST_ASSERT(nanvix_rcache_free(page_num[i]) == 0);
+	nanvix_rcache_clean();
+}
+
+/*============================================================================*
+ * API Test: Hints                                                            *
+ *============================================================================*/
+
+/**
+ * @brief API Test: Hints
+ */
+static void test_rmem_rcache_hints(void)
+{
+	nanvix_rcache_select_replacement_policy(RMEM_CACHE_FIFO);
+
+	TEST_ASSERT(nanvix_rcache_prefetch(RMEM_NULL, 1) < 0);
+	TEST_ASSERT(nanvix_rcache_release(RMEM_NULL, 1) < 0);
+
+	for (int i = 0; i < (RMEM_CACHE_LENGTH+1)*RMEM_CACHE_BLOCK_SIZE; i++)
+		TEST_ASSERT((page_num[i] = nanvix_rcache_alloc()) != RMEM_NULL);
+
+	TEST_ASSERT(nanvix_rcache_prefetch(page_num[0], 0) < 0);
+	TEST_ASSERT(nanvix_rcache_release(page_num[0], 0) < 0);
+
+	for (int i = 0; i < RMEM_CACHE_LENGTH; i++)
+	{
+		TEST_ASSERT((cache_data = nanvix_rcache_get(page_num[i*RMEM_CACHE_BLOCK_SIZE])) != NULL);
+		umemset(cache_data, i+1, RMEM_BLOCK_SIZE);
+		TEST_ASSERT(nanvix_rcache_dirty(page_num[i*RMEM_CACHE_BLOCK_SIZE]) == 0);
+		TEST_ASSERT(nanvix_rcache_put(page_num[i*RMEM_CACHE_BLOCK_SIZE], 0) == 0);
+	}
+
+	/* Released line is evicted first. */
+	TEST_ASSERT(nanvix_rcache_release(page_num[(RMEM_CACHE_LENGTH-1)*RMEM_CACHE_BLOCK_SIZE], 1) == 0);
+	TEST_ASSERT(nanvix_rcache_get(page_num[RMEM_CACHE_LENGTH*RMEM_CACHE_BLOCK_SIZE]) != NULL);
+	TEST_ASSERT(nanvix_rcache_put(page_num[RMEM_CACHE_LENGTH*RMEM_CACHE_BLOCK_SIZE], 0) == 0);
+	TEST_ASSERT(nanvix_rcache_dirty(page_num[(RMEM_CACHE_LENGTH-1)*RMEM_CACHE_BLOCK_SIZE]) < 0);
+	TEST_ASSERT(nanvix_rcache_dirty(page_num[0]) == 0);
+
+	/* Hinted line is loaded in background. */
+	TEST_ASSERT(nanvix_rcache_prefetch(page_num[(RMEM_CACHE_LENGTH-1)*RMEM_CACHE_BLOCK_SIZE], 1) == 0);
+	TEST_ASSERT(nanvix_rcache_sync() == 0);
+	TEST_ASSERT(nanvix_rcache_stats(&stats_before) == 0);
+	TEST_ASSERT((cache_data = nanvix_rcache_get(page_num[(RMEM_CACHE_LENGTH-1)*RMEM_CACHE_BLOCK_SIZE])) != NULL);
+	TEST_ASSERT(nanvix_rcache_stats(&stats_after) == 0);
+	TEST_ASSERT(stats_after.nmisses == stats_before.nmisses);
+
+	/* Checksum */
+	for (size_t i = 0; i < RMEM_BLOCK_SIZE; i++)
+		TEST_ASSERT(cache_data[i] == (char)(RMEM_CACHE_LENGTH));
+	TEST_ASSERT(nanvix_rcache_put(page_num[(RMEM_CACHE_LENGTH-1)*RMEM_CACHE_BLOCK_SIZE], 0) == 0);
+
+	for (int i = 0; i < (RMEM_CACHE_LENGTH+1)*RMEM_CACHE_BLOCK_SIZE; i++)
+		TEST_ASSERT(nanvix_rcache_free(page_num[i]) == 0);
+	nanvix_rcache_clean();
+}
+
+/*============================================================================*
+ * API Test: Zero Pages                                                       *
+ *============================================================================*/
+
+/**
+ * @brief API Test: Zero Pages
+ */
+static void test_rmem_rcache_zero(void)
+{
+	for (int i = 0; i < RMEM_CACHE_BLOCK_SIZE; i++)
+		TEST_ASSERT((page_num[i] = nanvix_rcache_alloc()) != RMEM_NULL);
+
+	/* Fresh page is not read. */
+	TEST_ASSERT(nanvix_rcache_stats(&stats_before) == 0);
+	TEST_ASSERT((cache_data = nanvix_rcache_get(page_num[0])) != NULL);
+	TEST_ASSERT(nanvix_rcache_stats(&stats_after) == 0);
+	TEST_ASSERT(stats_after.nread == stats_before.nread);
+
+	/* Checksum */
+	for (size_t i = 0; i < RMEM_BLOCK_SIZE; i++)
+		TEST_ASSERT(cache_data[i] == 0);
+
+	umemset(cache_data, 1, RMEM_BLOCK_SIZE);
+	TEST_ASSERT(nanvix_rcache_flush(page_num[0]) == 0);
+	TEST_ASSERT(nanvix_rcache_put(page_num[0], 0) == 0);
+	nanvix_rcache_clean();
+
+	/* Written page is read. */
+	TEST_ASSERT(nanvix_rcache_stats(&stats_before) == 0);
+	TEST_ASSERT((cache_data = nanvix_rcache_get(page_num[0])) != NULL);
+	TEST_ASSERT(nanvix_rcache_stats(&stats_after) == 0);
+	TEST_ASSERT(stats_after.nread == stats_before.nread + RMEM_CACHE_BLOCK_SIZE*RMEM_BLOCK_SIZE);
+
+	/* Checksum */
+	for (size_t i = 0; i < RMEM_BLOCK_SIZE; i++)
+		TEST_ASSERT(cache_data[i] == 1);
+
+	TEST_ASSERT(nanvix_rcache_put(page_num[0], 0) == 0);
+
+	for (int i = 0; i < RMEM_CACHE_BLOCK_SIZE; i++)
+		TEST_ASSERT(nanvix_rcache_free(page_num[i]) == 0);
+	nanvix_rcache_clean();
+}
+
+/*============================================================================*
+ * API Test: Overwrite                                                        *
+ *============================================================================*/
+
+/**
+ * @brief API Test: Overwrite
+ */
+static void test_rmem_rcache_overwrite(void)
+{
+	TEST_ASSERT(nanvix_rcache_overwrite(RMEM_NULL) == NULL);
+
+	for (int i = 0; i < RMEM_CACHE_BLOCK_SIZE; i++)
+		TEST_ASSERT((page_num[i] = nanvix_rcache_alloc()) != RMEM_NULL);
+
+	TEST_ASSERT((cache_data = nanvix_rcache_get(page_num[0])) != NULL);
+	umemset(cache_data, 1, RMEM_BLOCK_SIZE);
+	TEST_ASSERT(nanvix_rcache_flush(page_num[0]) == 0);
+	TEST_ASSERT(nanvix_rcache_put(page_num[0], 0) == 0);
+	nanvix_rcache_clean();
+
+	/* Overwritten page is not read. */
+	TEST_ASSERT(nanvix_rcache_stats(&stats_before) == 0);
+	TEST_ASSERT((cache_data = nanvix_rcache_overwrite(page_num[0])) != NULL);
+	TEST_ASSERT(nanvix_rcache_stats(&stats_after) == 0);
+	TEST_ASSERT(stats_after.nmisses == stats_before.nmisses + 1);
+	TEST_ASSERT(stats_after.nread == stats_before.nread + (RMEM_CACHE_BLOCK_SIZE - 1)*RMEM_BLOCK_SIZE);
+	umemset(cache_data, 2, RMEM_BLOCK_SIZE);
+	TEST_ASSERT(nanvix_rcache_put(page_num[0], 0) == 0);
+
+	/* Overwritten page is written back. */
+	TEST_ASSERT(nanvix_rcache_init(RMEM_CACHE_LENGTH, RMEM_CACHE_BLOCK_SIZE) == 0);
+	TEST_ASSERT(nanvix_rcache_sync() == 0);
+	TEST_ASSERT((cache_data = nanvix_rcache_get(page_num[0])) != NULL);
+
+	/* Checksum */
+	for (size_t i = 0; i < RMEM_BLOCK_SIZE; i++)
+		TEST_ASSERT(cache_data[i] == 2);
+
+	TEST_ASSERT(nanvix_rcache_put(page_num[0], 0) == 0);
+
+	for (int i = 0; i < RMEM_CACHE_BLOCK_SIZE; i++)
+		TEST_ASSERT(nanvix_rcache_free(page_num[i]) == 0);
+	nanvix_rcache_clean();
+}
+
+/*============================================================================*
+ * API Test: Bypass                                                           *
+ *============================================================================*/
+
+/**
+ * @brief Buffer of accesses that bypass the cache.
+ */
+static char bypass_buffer[RMEM_BLOCK_SIZE];
+
+/**
+ * @brief API Test: Bypass
+ */
+static void test_rmem_rcache_bypass(void)
+{
+	TEST_ASSERT(nanvix_rcache_bypass_read(RMEM_NULL, bypass_buffer, 0, RMEM_BLOCK_SIZE) < 0);
+	TEST_ASSERT(nanvix_rcache_bypass_write(RMEM_NULL, bypass_buffer, 0, RMEM_BLOCK_SIZE) < 0);
+
+	TEST_ASSERT((page_num[0] = nanvix_rcache_alloc()) != RMEM_NULL);
+
+	TEST_ASSERT(nanvix_rcache_bypass_read(page_num[0], NULL, 0, RMEM_BLOCK_SIZE) < 0);
+	TEST_ASSERT(nanvix_rcache_bypass_read(page_num[0], bypass_buffer, 1, RMEM_BLOCK_SIZE) < 0);
+	TEST_ASSERT(nanvix_rcache_bypass_write(page_num[0], bypass_buffer, 0, 0) < 0);
+
+	/* Pages are not cached. */
+	TEST_ASSERT(nanvix_rcache_stats(&stats_before) == 0);
+	umemset(bypass_buffer, 1, RMEM_BLOCK_SIZE);
+	TEST_ASSERT(nanvix_rcache_bypass_write(page_num[0], bypass_buffer, 0, RMEM_BLOCK_SIZE) == 0);
+	umemset(bypass_buffer, 2, RMEM_BLOCK_SIZE);
+	TEST_ASSERT(nanvix_rcache_bypass_write(page_num[0], bypass_buffer, 0, 1) == 0);
+	umemset(bypass_buffer, 0, RMEM_BLOCK_SIZE);
+	TEST_ASSERT(nanvix_rcache_bypass_read(page_num[0], bypass_buffer, 0, 2) == 0);
+	TEST_ASSERT(nanvix_rcache_stats(&stats_after) == 0);
+	TEST_ASSERT(stats_after.nmisses == stats_before.nmisses);
+	TEST_ASSERT(stats_after.nhits == stats_before.nhits);
+	TEST_ASSERT(nanvix_rcache_dirty(page_num[0]) < 0);
+	TEST_ASSERT((bypass_buffer[0] == 2) && (bypass_buffer[1] == 1));
+
+	/* Cached pages are kept up to date. */
+	TEST_ASSERT((cache_data = nanvix_rcache_get(page_num[0])) != NULL);
+	TEST_ASSERT((cache_data[0] == 2) && (cache_data[1] == 1));
+	umemset(bypass_buffer, 3, RMEM_BLOCK_SIZE);
+	TEST_ASSERT(nanvix_rcache_bypass_write(page_num[0], bypass_buffer, 1, 1) == 0);
+	TEST_ASSERT(cache_data[1] == 3);
+	TEST_ASSERT(nanvix_rcache_put(page_num[0], 0) == 0);
+
+	/* Modified pages are written back. */
+	TEST_ASSERT(nanvix_rcache_init(RMEM_CACHE_LENGTH, RMEM_CACHE_BLOCK_SIZE) == 0);
+	TEST_ASSERT(nanvix_rcache_sync() == 0);
+	umemset(bypass_buffer, 0, RMEM_BLOCK_SIZE);
+	TEST_ASSERT(nanvix_rcache_bypass_read(page_num[0], bypass_buffer, 0, RMEM_BLOCK_SIZE) == 0);
+	TEST_ASSERT((bypass_buffer[0] == 2) && (bypass_buffer[1] == 3) && (bypass_buffer[2] == 1));
+
+	TEST_ASSERT(nanvix_rcache_free(page_num[0]) == 0);
+	nanvix_rcache_clean();
+}
+
+/*============================================================================*
+ * API Test: Admission Filter                                                 *
+ *============================================================================*/
+
+/**
+ * @brief API Test: Admission Filter
+ */
+static void test_rmem_rcache_filter(void)
+{
+	rpage_t once;
+
+	nanvix_rcache_select_replacement_policy(RMEM_CACHE_FIFO);
+	TEST_ASSERT(nanvix_rcache_select_filter(1) == 0);
+
+	for (int i = 0; i < (RMEM_CACHE_LENGTH+1)*RMEM_CACHE_BLOCK_SIZE; i++)
+		TEST_ASSERT((page_num[i] = nanvix_rcache_alloc()) != RMEM_NULL);
+	TEST_ASSERT((once = nanvix_rcache_alloc()) != RMEM_NULL);
+
+	/* Fill up the cache with pages that are used twice. */
+	for (int k = 0; k < 2; k++)
+	{
+		for (int i = 0; i < RMEM_CACHE_LENGTH; i++)
+		{
+			TEST_ASSERT(nanvix_rcache_get(page_num[i*RMEM_CACHE_BLOCK_SIZE]) != NULL);
+			TEST_ASSERT(nanvix_rcache_put(page_num[i*RMEM_CACHE_BLOCK_SIZE], 0) == 0);
+		}
+	}
+
+	/* Pages used once replace each other. */
+	TEST_ASSERT(nanvix_rcache_stats(&stats_before) == 0);
+	TEST_ASSERT(nanvix_rcache_get(page_num[RMEM_CACHE_LENGTH*RMEM_CACHE_BLOCK_SIZE]) != NULL);
+	TEST_ASSERT(nanvix_rcache_put(page_num[RMEM_CACHE_LENGTH*RMEM_CACHE_BLOCK_SIZE], 0) == 0);
+	TEST_ASSERT(nanvix_rcache_get(once) != NULL);
+	TEST_ASSERT(nanvix_rcache_put(once, 0) == 0);
+	TEST_ASSERT(nanvix_rcache_stats(&stats_after) == 0);
+	TEST_ASSERT(stats_after.nrejections == stats_before.nrejections + 2);
+	TEST_ASSERT(nanvix_rcache_dirty(page_num[RMEM_CACHE_LENGTH*RMEM_CACHE_BLOCK_SIZE]) < 0);
+	TEST_ASSERT(nanvix_rcache_dirty(page_num[RMEM_CACHE_BLOCK_SIZE]) == 0);
+
+	TEST_ASSERT(nanvix_rcache_select_filter(0) == 0);
+
+	for (int i = 0; i < (RMEM_CACHE_LENGTH+1)*RMEM_CACHE_BLOCK_SIZE; i++)
+		TEST_ASSERT(nanvix_rcache_free(page_num[i]) == 0);
+	TEST_ASSERT(nanvix_rcache_free(once) == 0);
+	nanvix_rcache_clean();
+}
+
+/*============================================================================*
+ * API Test: Adaptive                                                         *
+ *============================================================================*/
+
+/**
+ * @brief API Test: Adaptive
+ */
+static void test_rmem_rcache_adaptive(void)
+{
+	TEST_ASSERT(nanvix_rcache_select_replacement_policy(RMEM_CACHE_ADAPTIVE) == 0);
+
+	for (int i = 0; i < (RMEM_CACHE_LENGTH+1)*RMEM_CACHE_BLOCK_SIZE; i++)
+		TEST_ASSERT((page_num[i] = nanvix_rcache_alloc()) != RMEM_NULL);
+
+	/* Sets run different policies. */
+	TEST_ASSERT(nanvix_rcache_select_associativity((RMEM_CACHE_LENGTH >= 16) ? (RMEM_CACHE_LENGTH/8) : 1) == 0);
+	for (int k = 0; k < 3; k++)
+	{
+		for (int i = 0; i < (RMEM_CACHE_LENGTH+1)*RMEM_CACHE_BLOCK_SIZE; i += (k + 1))
+		{
+			TEST_ASSERT((cache_data = nanvix_rcache_get(page_num[i])) != NULL);
+			umemset(cache_data, i+k+1, RMEM_BLOCK_SIZE);
+			TEST_ASSERT(nanvix_rcache_dirty(page_num[i]) == 0);
+			TEST_ASSERT(nanvix_rcache_put(page_num[i], 0) == 0);
+		}
+	}
+
+	/* Modified pages are written back. */
+	TEST_ASSERT(nanvix_rcache_select_associativity(RMEM_CACHE_WAYS) == 0);
+
+	/* Checksum */
+	for (int i = 0; i < (RMEM_CACHE_LENGTH+1)*RMEM_CACHE_BLOCK_SIZE; i++)
+	{
+		TEST_ASSERT((cache_data = nanvix_rcache_get(page_num[i])) != NULL);
+		for (size_t j = 0; j < RMEM_BLOCK_SIZE; j++)
+			TEST_ASSERT(cache_data[j] == (char)(i + ((i%3 == 0) ? 3 : ((i%2 == 0) ? 2 : 1))));
+		TEST_ASSERT(nanvix_rcache_put(page_num[i], 0) == 0);
+	}
+
+	for (int i = 0; i < (RMEM_CACHE_LENGTH+1)*RMEM_CACHE_BLOCK_SIZE; i++)
+		TEST_ASSERT(nanvix_rcache_free(page_num[i]) == 0);
+	nanvix_rcache_clean();
+}
+
 /*============================================================================*
  * Test Driver Table                                                          *
  *============================================================================*/
@@ -403,12 +1267,28 @@ static void test_rmem_rcache_aging(void)
  * @brief Unit tests.
  */
 struct test tests_rmem_cache_api[] = {
-	{ test_rmem_rcache_alloc_free, "alloc free" },
-	{ test_rmem_rcache_put_write,  "put write"  },
-	{ test_rmem_rcache_get_flush,  "get flush"  },
-	{ test_rmem_rcache_fifo,       "fifo"       },
-	{ test_rmem_rcache_lifo,       "lifo"       },
-	{ test_rmem_rcache_lru,        "lru"        },
-	{ test_rmem_rcache_aging,      "aging"      },
-	{ NULL,                         NULL        },
+	{ test_rmem_rcache_alloc_free,      "alloc free"    },
+	{ test_rmem_rcache_put_write,       "put write"     },
+	{ test_rmem_rcache_get_flush,       "get flush"     },
+	{ test_rmem_rcache_dirty,           "dirty"         },
+	{ test_rmem_rcache_fifo,            "fifo"          },
+	{ test_rmem_rcache_lifo,            "lifo"          },
+	{ test_rmem_rcache_lru,             "lru"           },
+	{ test_rmem_rcache_aging,           "aging"         },
+	{ test_rmem_rcache_clock,           "clock"         },
+	{ test_rmem_rcache_2q,              "2q"            },
+	{ test_rmem_rcache_sync,            "sync"          },
+	{ test_rmem_rcache_associativity,   "associativity" },
+	{ test_rmem_rcache_resize,          "resize"        },
+	{ test_rmem_rcache_prefetch,        "prefetch"      },
+	{ test_rmem_rcache_stats,           "stats"         },
+	{ test_rmem_rcache_victim,          "victim"        },
+	{ test_rmem_rcache_mrc,             "mrc"           },
+	{ test_rmem_rcache_hints,           "hints"         },
+	{ test_rmem_rcache_zero,            "zero"          },
+	{ test_rmem_rcache_overwrite,       "overwrite"     },
+	{ test_rmem_rcache_bypass,          "bypass"        },
+	{ test_rmem_rcache_filter,          "filter"        },
+	{ test_rmem_rcache_adaptive,        "adaptive"      },
+	{ NULL,                             NULL            },
 };
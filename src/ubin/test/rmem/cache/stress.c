@@ -0,0 +1,316 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2011-2019 The Maintainers of Nanvix
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#define __NEED_RMEM_CACHE
+
+#include <nanvix/runtime/rmem.h>
+#include <nanvix/runtime/runtime.h>
+#include <nanvix/sys/thread.h>
+#include <nanvix/ulib.h>
+#include "../../test.h"
+
+/**
+ * @brief Number of threads.
+ *
+ * The main thread, and the exception handler, the write-behind thread
+ * and the prefetcher of the runtime also run in this cluster, thus six
+ * threads in total.
+ */
+#define NUM_THREADS 2
+
+/**
+ * @brief Number of threads of this cluster that are not workers.
+ */
+#define NUM_OTHER_THREADS 4
+
+/**
+ * @brief Number of pages accessed by each thread.
+ */
+#define NUM_PAGES RMEM_CACHE_LENGTH
+
+/**
+ * @brief Number of passes over the pages.
+ */
+#define NUM_ITERATIONS 4
+
+/**
+ * @brief Pages of each thread.
+ */
+static rpage_t pages[NUM_THREADS][NUM_PAGES];
+
+/**
+ * @brief Pages shared by all threads.
+ */
+static rpage_t shared[NUM_PAGES];
+
+/*============================================================================*
+ * Stress Test: Private Pages                                                 *
+ *============================================================================*/
+
+/**
+ * @brief Writes and checks pages of a thread.
+ *
+ * Threads together access more pages than the cache holds, thus lines
+ * are evicted and modified pages are written back while other threads
+ * hit the cache.
+ *
+ * @param args Number of the thread.
+ *
+ * @returns Always NULL.
+ */
+static void *do_private(void *args)
+{
+	int tnum;
+	char *data;
+
+	tnum = *((int *) args);
+
+	uassert(__runtime_setup(2) == 0);
+
+		for (int k = 0; k < NUM_ITERATIONS; k++)
+		{
+			for (int i = 0; i < NUM_PAGES; i++)
+			{
+				TEST_ASSERT((data = nanvix_rcache_get(pages[tnum][i])) != NULL);
+
+				/* Checksum. */
+				for (size_t j = 0; j < RMEM_BLOCK_SIZE; j++)
+					TEST_ASSERT(data[j] == (char)((k == 0) ? 0 : (tnum*NUM_PAGES + i + k)));
+
+				umemset(data, tnum*NUM_PAGES + i + k + 1, RMEM_BLOCK_SIZE);
+				TEST_ASSERT(nanvix_rcache_dirty(pages[tnum][i]) == 0);
+				TEST_ASSERT(nanvix_rcache_put(pages[tnum][i], 0) == 0);
+			}
+		}
+
+	uassert(__runtime_cleanup() == 0);
+
+	return (NULL);
+}
+
+/**
+ * @brief Stress Test: Private Pages
+ */
+static void test_rmem_rcache_private(void)
+{
+	int args[NUM_THREADS];
+	kthread_t tids[NUM_THREADS];
+
+	for (int i = 0; i < NUM_THREADS; i++)
+	{
+		for (int j = 0; j < NUM_PAGES; j++)
+			TEST_ASSERT((pages[i][j] = nanvix_rcache_alloc()) != RMEM_NULL);
+	}
+
+	uassert((NUM_THREADS + NUM_OTHER_THREADS) <= THREAD_MAX);
+
+	for (int i = 0; i < NUM_THREADS; i++)
+	{
+		args[i] = i;
+		TEST_ASSERT(kthread_create(&tids[i], do_private, &args[i]) == 0);
+	}
+	for (int i = 0; i < NUM_THREADS; i++)
+		TEST_ASSERT(kthread_join(tids[i], NULL) == 0);
+
+	for (int i = 0; i < NUM_THREADS; i++)
+	{
+		for (int j = 0; j < NUM_PAGES; j++)
+			TEST_ASSERT(nanvix_rcache_free(pages[i][j]) == 0);
+	}
+	nanvix_rcache_clean();
+}
+
+/*============================================================================*
+ * Stress Test: Shared Pages                                                  *
+ *============================================================================*/
+
+/**
+ * @brief Counts on shared pages.
+ *
+ * Each thread increments its own byte of every page, so an update is
+ * lost if a page is loaded twice or dropped while modified.
+ *
+ * @param args Number of the thread.
+ *
+ * @returns Always NULL.
+ */
+static void *do_shared(void *args)
+{
+	int tnum;
+	char *data;
+
+	tnum = *((int *) args);
+
+	uassert(__runtime_setup(2) == 0);
+
+		for (int k = 0; k < NUM_ITERATIONS; k++)
+		{
+			for (int i = 0; i < NUM_PAGES; i++)
+			{
+				TEST_ASSERT((data = nanvix_rcache_get(shared[i])) != NULL);
+				data[tnum]++;
+				TEST_ASSERT(nanvix_rcache_dirty(shared[i]) == 0);
+				TEST_ASSERT(nanvix_rcache_put(shared[i], 0) == 0);
+			}
+		}
+
+	uassert(__runtime_cleanup() == 0);
+
+	return (NULL);
+}
+
+/**
+ * @brief Stress Test: Shared Pages
+ */
+static void test_rmem_rcache_shared(void)
+{
+	char *data;
+	int args[NUM_THREADS];
+	kthread_t tids[NUM_THREADS];
+
+	for (int i = 0; i < NUM_PAGES; i++)
+		TEST_ASSERT((shared[i] = nanvix_rcache_alloc()) != RMEM_NULL);
+
+	/* Keep the cache small, so that lines keep moving. */
+	TEST_ASSERT(nanvix_rcache_init(NUM_THREADS + 1, 1) == 0);
+
+	uassert((NUM_THREADS + NUM_OTHER_THREADS) <= THREAD_MAX);
+
+	for (int i = 0; i < NUM_THREADS; i++)
+	{
+		args[i] = i;
+		TEST_ASSERT(kthread_create(&tids[i], do_shared, &args[i]) == 0);
+	}
+	for (int i = 0; i < NUM_THREADS; i++)
+		TEST_ASSERT(kthread_join(tids[i], NULL) == 0);
+
+	/* Checksum. */
+	for (int i = 0; i < NUM_PAGES; i++)
+	{
+		TEST_ASSERT((data = nanvix_rcache_get(shared[i])) != NULL);
+		for (int j = 0; j < NUM_THREADS; j++)
+			TEST_ASSERT(data[j] == NUM_ITERATIONS);
+		TEST_ASSERT(nanvix_rcache_put(shared[i], 0) == 0);
+	}
+
+	for (int i = 0; i < NUM_PAGES; i++)
+		TEST_ASSERT(nanvix_rcache_free(shared[i]) == 0);
+	TEST_ASSERT(nanvix_rcache_init(RMEM_CACHE_LENGTH, RMEM_CACHE_BLOCK_SIZE) == 0);
+}
+
+/*============================================================================*
+ * Stress Test: Pinned Pages                                                  *
+ *============================================================================*/
+
+/**
+ * @brief Holds pages of a thread while other threads miss.
+ *
+ * The cache has fewer lines than threads, thus a thread that misses
+ * finds every line in use, and it should wait rather than take the
+ * frame of a page that another thread holds.
+ *
+ * @param args Number of the thread.
+ *
+ * @returns Always NULL.
+ */
+static void *do_pinned(void *args)
+{
+	int tnum;
+	char *data;
+
+	tnum = *((int *) args);
+
+	uassert(__runtime_setup(2) == 0);
+
+		for (int k = 0; k < NUM_ITERATIONS; k++)
+		{
+			for (int i = 0; i < NUM_PAGES; i++)
+			{
+				TEST_ASSERT((data = nanvix_rcache_get(pages[tnum][i])) != NULL);
+				umemset(data, tnum*NUM_PAGES + i + k + 1, RMEM_BLOCK_SIZE);
+
+				/* Let other threads miss. */
+				kthread_yield();
+
+				/* Checksum. */
+				for (size_t j = 0; j < RMEM_BLOCK_SIZE; j++)
+					TEST_ASSERT(data[j] == (char)(tnum*NUM_PAGES + i + k + 1));
+
+				TEST_ASSERT(nanvix_rcache_put(pages[tnum][i], 0) == 0);
+			}
+		}
+
+	uassert(__runtime_cleanup() == 0);
+
+	return (NULL);
+}
+
+/**
+ * @brief Stress Test: Pinned Pages
+ */
+static void test_rmem_rcache_pinned(void)
+{
+	int args[NUM_THREADS];
+	kthread_t tids[NUM_THREADS];
+
+	for (int i = 0; i < NUM_THREADS; i++)
+	{
+		for (int j = 0; j < NUM_PAGES; j++)
+			TEST_ASSERT((pages[i][j] = nanvix_rcache_alloc()) != RMEM_NULL);
+	}
+
+	/* More threads than ways. */
+	TEST_ASSERT(nanvix_rcache_init(NUM_THREADS - 1, 1) == 0);
+
+	uassert((NUM_THREADS + NUM_OTHER_THREADS) <= THREAD_MAX);
+
+	for (int i = 0; i < NUM_THREADS; i++)
+	{
+		args[i] = i;
+		TEST_ASSERT(kthread_create(&tids[i], do_pinned, &args[i]) == 0);
+	}
+	for (int i = 0; i < NUM_THREADS; i++)
+		TEST_ASSERT(kthread_join(tids[i], NULL) == 0);
+
+	for (int i = 0; i < NUM_THREADS; i++)
+	{
+		for (int j = 0; j < NUM_PAGES; j++)
+			TEST_ASSERT(nanvix_rcache_free(pages[i][j]) == 0);
+	}
+	TEST_ASSERT(nanvix_rcache_init(RMEM_CACHE_LENGTH, RMEM_CACHE_BLOCK_SIZE) == 0);
+}
+
+/*============================================================================*
+ * Test Driver Table                                                          *
+ *============================================================================*/
+
+/**
+ * @brief Unit tests.
+ */
+struct test tests_rmem_cache_stress[] = {
+	{ test_rmem_rcache_private, "private pages" },
+	{ test_rmem_rcache_shared,  "shared pages"  },
+	{ test_rmem_rcache_pinned,  "pinned pages"  },
+	{ NULL,                     NULL            },
+};
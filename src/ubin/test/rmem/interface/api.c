@@ -33,6 +33,26 @@
  */
 static char buffer[RMEM_BLOCK_SIZE];
 
+/**
+ * @brief Number of pages spanned by large transfers.
+ */
+#define NUM_PAGES 4
+
+/**
+ * @brief Buffer of large transfers.
+ */
+static char large[NUM_PAGES*RMEM_BLOCK_SIZE];
+
+/**
+ * @brief Number of pages spanned by reads larger than the cache.
+ */
+#define NUM_HUGE_PAGES (RMEM_CACHE_SIZE + NUM_PAGES)
+
+/**
+ * @brief Buffer of reads larger than the cache.
+ */
+static char huge[NUM_HUGE_PAGES*RMEM_BLOCK_SIZE];
+
 /*============================================================================*
  * API Test: Alloc/Free                                                       *
  *============================================================================*/
@@ -56,6 +76,126 @@ static void test_rmem_interface_alloc_free(void)
 #endif
 }
 
+/*============================================================================*
+ * API Test: Alloc/Free Holes                                                 *
+ *============================================================================*/
+
+/**
+ * @brief API Test: Alloc/Free Holes
+ */
+static void test_rmem_interface_alloc_free_holes(void)
+{
+	char *ptr[3];
+	char *hole;
+
+	TEST_ASSERT((ptr[0] = nanvix_vmem_alloc(NUM_PAGES)) != NULL);
+	TEST_ASSERT((ptr[1] = nanvix_vmem_alloc(1)) != NULL);
+	TEST_ASSERT((ptr[2] = nanvix_vmem_alloc(NUM_PAGES)) != NULL);
+
+	umemset(buffer, 1, RMEM_BLOCK_SIZE);
+	TEST_ASSERT(nanvix_vmem_write(ptr[2], buffer, RMEM_BLOCK_SIZE) == RMEM_BLOCK_SIZE);
+
+	/* Only the start of a region may be freed. */
+	TEST_ASSERT(nanvix_vmem_free(&ptr[0][RMEM_BLOCK_SIZE]) < 0);
+
+	/* Later regions outlive earlier ones. */
+	TEST_ASSERT(nanvix_vmem_free(ptr[0]) == 0);
+	TEST_ASSERT(nanvix_vmem_free(ptr[0]) < 0);
+	umemset(buffer, 0, RMEM_BLOCK_SIZE);
+	TEST_ASSERT(nanvix_vmem_read(buffer, ptr[2], RMEM_BLOCK_SIZE) == RMEM_BLOCK_SIZE);
+	for (size_t i = 0; i < RMEM_BLOCK_SIZE; i++)
+		TEST_ASSERT(buffer[i] == 1);
+
+	/* Holes are reused. */
+	TEST_ASSERT((hole = nanvix_vmem_alloc(NUM_PAGES - 1)) == ptr[0]);
+	TEST_ASSERT(nanvix_vmem_free(ptr[1]) == 0);
+
+	/* Free extents are merged. */
+	TEST_ASSERT(nanvix_vmem_free(hole) == 0);
+	TEST_ASSERT((hole = nanvix_vmem_alloc(NUM_PAGES + 1)) == ptr[0]);
+
+	TEST_ASSERT(nanvix_vmem_free(hole) == 0);
+	TEST_ASSERT(nanvix_vmem_free(ptr[2]) == 0);
+}
+
+/*============================================================================*
+ * API Test: Alloc/Free Many                                                  *
+ *============================================================================*/
+
+/**
+ * @brief API Test: Alloc/Free Many
+ */
+static void test_rmem_interface_alloc_free_many(void)
+{
+	char *ptr[3];
+	size_t n = RMEM_NUM_BLOCKS/4;
+
+	for (int i = 0; i < 3; i++)
+	{
+		TEST_ASSERT((ptr[i] = nanvix_vmem_alloc(n)) != NULL);
+
+		/* Last page. */
+		umemset(buffer, i + 1, RMEM_BLOCK_SIZE);
+		TEST_ASSERT(nanvix_vmem_write(&ptr[i][(n - 1)*RMEM_BLOCK_SIZE], buffer, RMEM_BLOCK_SIZE) == RMEM_BLOCK_SIZE);
+	}
+
+	/* Middle region goes first. */
+	TEST_ASSERT(nanvix_vmem_free(ptr[1]) == 0);
+	TEST_ASSERT((ptr[1] = nanvix_vmem_alloc(n)) != NULL);
+	TEST_ASSERT(nanvix_vmem_free(ptr[1]) == 0);
+
+	for (int i = 0; i < 3; i += 2)
+	{
+		/* Checksum. */
+		umemset(buffer, 0, RMEM_BLOCK_SIZE);
+		TEST_ASSERT(nanvix_vmem_read(buffer, &ptr[i][(n - 1)*RMEM_BLOCK_SIZE], RMEM_BLOCK_SIZE) == RMEM_BLOCK_SIZE);
+		for (size_t j = 0; j < RMEM_BLOCK_SIZE; j++)
+			TEST_ASSERT(buffer[j] == (char)(i + 1));
+
+		TEST_ASSERT(nanvix_vmem_free(ptr[i]) == 0);
+	}
+}
+
+/*============================================================================*
+ * API Test: Reserve                                                          *
+ *============================================================================*/
+
+/**
+ * @brief API Test: Reserve
+ */
+static void test_rmem_interface_reserve(void)
+{
+	char *ptr;
+	size_t n = RMEM_SERVERS_NUM*RMEM_NUM_BLOCKS + 1;
+
+	/* Reserve more than remote memory holds. */
+	TEST_ASSERT((ptr = nanvix_vmem_reserve(n)) != NULL);
+
+	/* Untouched pages read as zeros. */
+	umemset(large, 1, NUM_PAGES*RMEM_BLOCK_SIZE);
+	TEST_ASSERT(nanvix_vmem_read(large, &ptr[RMEM_BLOCK_SIZE/2], NUM_PAGES*RMEM_BLOCK_SIZE) == NUM_PAGES*RMEM_BLOCK_SIZE);
+	for (size_t i = 0; i < NUM_PAGES*RMEM_BLOCK_SIZE; i++)
+		TEST_ASSERT(large[i] == 0);
+
+	/* Touch first and last pages. */
+	for (size_t j = 0; j < n; j += n - 1)
+	{
+		umemset(buffer, (j == 0) ? 1 : 2, RMEM_BLOCK_SIZE/2);
+		TEST_ASSERT(nanvix_vmem_write(&ptr[j*RMEM_BLOCK_SIZE + 1], buffer, RMEM_BLOCK_SIZE/2) == RMEM_BLOCK_SIZE/2);
+	}
+
+	/* Checksum. */
+	for (size_t j = 0; j < n; j += n - 1)
+	{
+		umemset(buffer, 9, RMEM_BLOCK_SIZE);
+		TEST_ASSERT(nanvix_vmem_read(buffer, &ptr[j*RMEM_BLOCK_SIZE], RMEM_BLOCK_SIZE) == RMEM_BLOCK_SIZE);
+		for (size_t i = 0; i < RMEM_BLOCK_SIZE; i++)
+			TEST_ASSERT(buffer[i] == (((i == 0) || (i > RMEM_BLOCK_SIZE/2)) ? 0 : ((j == 0) ? 1 : 2)));
+	}
+
+	TEST_ASSERT(nanvix_vmem_free(ptr) == 0);
+}
+
 /*============================================================================*
  * API Test: Read/Write                                                       *
  *============================================================================*/
@@ -97,13 +237,138 @@ static void test_rmem_interface_read_write(void)
 	TEST_ASSERT(nanvix_vmem_free(ptr) == 0);
 }
 
+/*============================================================================*
+ * API Test: Large Read/Write                                                 *
+ *============================================================================*/
+
+/**
+ * @brief API Test: Large Read/Write
+ */
+static void test_rmem_interface_large_read_write(void)
+{
+	char *ptr;
+	size_t n = (NUM_PAGES - 1)*RMEM_BLOCK_SIZE;
+
+	TEST_ASSERT((ptr = nanvix_vmem_alloc(NUM_PAGES)) != NULL);
+
+	for (size_t base = 0; base < RMEM_BLOCK_SIZE; base += RMEM_BLOCK_SIZE/4)
+	{
+		/* Unaligned write across pages. */
+		for (size_t i = 0; i < n; i++)
+			large[i] = (char)(base + i/RMEM_BLOCK_SIZE + 1);
+		TEST_ASSERT(nanvix_vmem_write(&ptr[base], large, n) == n);
+
+		/* Unaligned read across pages. */
+		umemset(large, 0, NUM_PAGES*RMEM_BLOCK_SIZE);
+		TEST_ASSERT(nanvix_vmem_read(large, &ptr[base], n) == n);
+
+		/* Checksum. */
+		for (size_t i = 0; i < n; i++)
+			TEST_ASSERT(large[i] == (char)(base + i/RMEM_BLOCK_SIZE + 1));
+	}
+
+	/* Range goes past the area. */
+	TEST_ASSERT(nanvix_vmem_read(large, &ptr[1], NUM_PAGES*RMEM_BLOCK_SIZE) == 0);
+
+	/* Length wraps around. */
+	TEST_ASSERT(nanvix_vmem_read(large, &ptr[1], ((size_t) -1) - RMEM_BLOCK_SIZE + 2) == 0);
+
+	TEST_ASSERT(nanvix_vmem_free(ptr) == 0);
+}
+
+/*============================================================================*
+ * API Test: Huge Read                                                        *
+ *============================================================================*/
+
+/**
+ * @brief API Test: Huge Read
+ *
+ * Pages hinted ahead of the copy should not be evicted before they
+ * are copied, thus each page is read from remote memory once at most.
+ */
+static void test_rmem_interface_huge_read(void)
+{
+	char *ptr;
+	size_t n = NUM_HUGE_PAGES*RMEM_BLOCK_SIZE;
+	struct nanvix_rcache_stats stats_before;
+	struct nanvix_rcache_stats stats_after;
+
+	TEST_ASSERT((ptr = nanvix_vmem_alloc(NUM_HUGE_PAGES)) != NULL);
+
+	for (size_t i = 0; i < n; i++)
+		huge[i] = (char)(i/RMEM_BLOCK_SIZE + 1);
+	TEST_ASSERT(nanvix_vmem_write(ptr, huge, n) == n);
+	TEST_ASSERT(nanvix_rcache_sync() == 0);
+
+	/* Read more pages than the cache holds. */
+	umemset(huge, 0, n);
+	TEST_ASSERT(nanvix_rcache_stats(&stats_before) == 0);
+	TEST_ASSERT(nanvix_vmem_read(huge, ptr, n) == n);
+	TEST_ASSERT(nanvix_rcache_sync() == 0);
+	TEST_ASSERT(nanvix_rcache_stats(&stats_after) == 0);
+	TEST_ASSERT((stats_after.nread - stats_before.nread) <= n);
+
+	/* Checksum. */
+	for (size_t i = 0; i < n; i++)
+		TEST_ASSERT(huge[i] == (char)(i/RMEM_BLOCK_SIZE + 1));
+
+	TEST_ASSERT(nanvix_vmem_free(ptr) == 0);
+}
+
+/*============================================================================*
+ * API Test: Stream Read/Write                                                *
+ *============================================================================*/
+
+/**
+ * @brief API Test: Stream Read/Write
+ */
+static void test_rmem_interface_stream_read_write(void)
+{
+	char *ptr;
+
+	TEST_ASSERT((ptr = nanvix_vmem_alloc(1)) != NULL);
+
+	for (size_t base = 0; base < RMEM_BLOCK_SIZE; base = (base == 0) ? 1 : (base << 1))
+	{
+		size_t n = RMEM_BLOCK_SIZE - base;
+
+		/* Streaming write. */
+		umemset(buffer, base & 0xff, RMEM_BLOCK_SIZE);
+		TEST_ASSERT(nanvix_vmem_stream_write(&ptr[base], buffer, n) == n);
+
+		/* Cached read. */
+		umemset(buffer, 0, RMEM_BLOCK_SIZE);
+		TEST_ASSERT(nanvix_vmem_read(buffer, &ptr[base], n) == n);
+
+		/* Checksum. */
+		for (size_t i = 0; i < n; i++)
+			TEST_ASSERT(buffer[i] == (char)(base & 0xff));
+
+		/* Streaming read. */
+		umemset(buffer, 0, RMEM_BLOCK_SIZE);
+		TEST_ASSERT(nanvix_vmem_stream_read(buffer, &ptr[base], n) == n);
+
+		/* Checksum. */
+		for (size_t i = 0; i < n; i++)
+			TEST_ASSERT(buffer[i] == (char)(base & 0xff));
+	}
+
+	TEST_ASSERT(nanvix_vmem_free(ptr) == 0);
+}
+
 /*============================================================================*/
 
 /**
  * @brief Unit tests.
  */
 struct test tests_rmem_interface_api[] = {
-	{ test_rmem_interface_alloc_free, "alloc/free"      },
-	{ test_rmem_interface_read_write, "read/write"      },
-	{ NULL,                            NULL             },
+	{ test_rmem_interface_alloc_free,        "alloc/free"        },
+	{ test_rmem_interface_alloc_free_holes,  "alloc/free holes"  },
+	{ test_rmem_interface_alloc_free_many,   "alloc/free many"   },
+	{ test_rmem_interface_reserve,           "reserve"           },
+	{ test_rmem_interface_read_write,        "read/write"        },
+	{ test_rmem_interface_large_read_write,  "large read/write"  },
+	{ test_rmem_interface_huge_read,         "huge read"         },
+	{ test_rmem_interface_stream_read_write, "stream read/write" },
+	{ NULL,                                   NULL               },
 };
@@ -48,6 +48,36 @@ static void test_rmem_manager_alloc_free(void)
 	TEST_ASSERT(nanvix_rmem_free(blknum) == 0);
 }
 
+/*============================================================================*
+ * API Test: Alloc/Free Many                                                  *
+ *============================================================================*/
+
+/**
+ * @brief Number of blocks in bulk allocations.
+ */
+#define NUM_BLOCKS (RMEM_ALLOC_N_MAX + 1)
+
+/**
+ * @brief API Test: Alloc/Free Many
+ */
+static void test_rmem_manager_alloc_free_many(void)
+{
+	rpage_t blknums[NUM_BLOCKS];
+
+	TEST_ASSERT(nanvix_rmem_alloc_n(blknums, NUM_BLOCKS) == 0);
+
+	/* Blocks are distinct. */
+	for (int i = 0; i < NUM_BLOCKS; i++)
+	{
+		TEST_ASSERT(blknums[i] != RMEM_NULL);
+		for (int j = 0; j < i; j++)
+			TEST_ASSERT(blknums[i] != blknums[j]);
+	}
+
+	for (int i = 0; i < NUM_BLOCKS; i++)
+		TEST_ASSERT(nanvix_rmem_free(blknums[i]) == 0);
+}
+
 /*============================================================================*
  * API Test: Read Write                                                       *
  *============================================================================*/
@@ -130,8 +160,9 @@ static void test_rmem_manager_consistency(void)
  * @brief Unit tests.
  */
 struct test tests_rmem_manager_api[] = {
-	{ test_rmem_manager_alloc_free, "alloc/free" },
-	{ test_rmem_manager_read_write, "read/write" },
-	{ test_rmem_manager_consistency, "consistency" },
-	{ NULL,                          NULL        },
+	{ test_rmem_manager_alloc_free,      "alloc/free"      },
+	{ test_rmem_manager_alloc_free_many, "alloc/free many" },
+	{ test_rmem_manager_read_write,      "read/write"      },
+	{ test_rmem_manager_consistency,     "consistency"     },
+	{ NULL,                               NULL             },
 };
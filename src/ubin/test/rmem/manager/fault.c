@@ -43,6 +43,22 @@
  */
 static char buffer[RMEM_BLOCK_SIZE];
 
+/*============================================================================*
+ * Fault Injection Test: Invalid Alloc                                        *
+ *============================================================================*/
+
+/**
+ * @brief Fault Injection Test: Invalid Alloc
+ */
+static void test_rmem_manager_invalid_alloc(void)
+{
+	rpage_t blknum;
+
+	TEST_ASSERT(nanvix_rmem_alloc_n(NULL, 1) == -EINVAL);
+	TEST_ASSERT(nanvix_rmem_alloc_n(&blknum, 0) == -EINVAL);
+	TEST_ASSERT(nanvix_rmem_alloc_n(&blknum, -1) == -EINVAL);
+}
+
 /*============================================================================*
  * Fault Injection Test: Invalid Free                                         *
  *============================================================================*/
@@ -163,6 +179,7 @@ static void test_rmem_manager_bad_read(void)
  * @brief Unit tests.
  */
 struct test tests_rmem_manager_fault[] = {
+	{ test_rmem_manager_invalid_alloc, "invalid alloc" },
 	{ test_rmem_manager_invalid_free,  "invalid free " },
 	{ test_rmem_manager_bad_free,      "bad free     " },
 	{ test_rmem_manager_invalid_write, "invalid write" },